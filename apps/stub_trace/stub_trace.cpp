@@ -0,0 +1,167 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+// Command-line tool printing the calls stored in a binary trace written by
+// stub::write_trace(...). Run without arguments for usage information.
+
+#include <stub/trace.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+void usage()
+{
+    std::cerr << "Usage: stub_trace [options] <trace file>\n"
+                 "\n"
+                 "Options:\n"
+                 "  --types          Only print the argument types\n"
+                 "  --from <index>   First call to print\n"
+                 "  --to <index>     Stop before this call\n"
+                 "  --arg <i>=<v>    Only print calls where argument i is v\n";
+}
+
+struct filter
+{
+    uint32_t m_index;
+    std::string m_value;
+};
+}
+
+int main(int argc, char* argv[])
+{
+    bool types_only = false;
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    std::vector<filter> filters;
+    std::string path;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option = argv[i];
+        bool has_value = i + 1 < argc;
+
+        if (option == "--types")
+        {
+            types_only = true;
+        }
+        else if (option == "--from" && has_value)
+        {
+            from = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (option == "--to" && has_value)
+        {
+            to = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (option == "--arg" && has_value)
+        {
+            std::string value = argv[++i];
+            auto separator = value.find('=');
+
+            if (separator == std::string::npos)
+            {
+                usage();
+                return EXIT_FAILURE;
+            }
+
+            filters.push_back(
+                {(uint32_t)std::strtoul(value.c_str(), nullptr, 10),
+                 value.substr(separator + 1)});
+        }
+        else if (path.empty() && option.compare(0, 2, "--") != 0)
+        {
+            path = option;
+        }
+        else
+        {
+            usage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (path.empty())
+    {
+        usage();
+        return EXIT_FAILURE;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Could not open " << path << "\n";
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        stub::trace_reader reader(file);
+
+        std::cout << "Types:";
+        for (const auto& type : reader.types())
+        {
+            std::cout << " " << type;
+        }
+        std::cout << "\nNumber of calls: " << reader.calls() << "\n";
+
+        if (types_only)
+            return EXIT_SUCCESS;
+
+        stub::format_buffer buffer;
+        std::vector<std::string> values;
+
+        while (reader.position() < to && reader.read_call(values))
+        {
+            uint64_t index = reader.position() - 1;
+
+            if (index < from)
+                continue;
+
+            bool selected = true;
+            for (const auto& f : filters)
+            {
+                selected = selected && f.m_index < values.size() &&
+                           values[f.m_index] == f.m_value;
+            }
+
+            if (!selected)
+                continue;
+
+            buffer.append("Call ");
+            buffer.append_value(index);
+            buffer.append(":\n");
+
+            for (uint32_t i = 0; i < values.size(); ++i)
+            {
+                buffer.append("Arg ");
+                buffer.append_value(i);
+                buffer.append(": ");
+                buffer.append(values[i].data(), values[i].size());
+                buffer.append('\n');
+            }
+
+            // Write the output in blocks to bound the memory used
+            if (buffer.size() >= 65536)
+            {
+                buffer.write_to(std::cout);
+                buffer.clear();
+            }
+        }
+
+        buffer.write_to(std::cout);
+    }
+    catch (const stub::trace_error& error)
+    {
+        std::cout.flush();
+        std::cerr << "Error: " << error.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
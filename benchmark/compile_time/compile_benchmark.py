@@ -0,0 +1,176 @@
+#! /usr/bin/env python
+# encoding: utf-8
+#
+# Copyright (c) 2026 Steinwurf ApS
+# All Rights Reserved
+#
+# Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+"""Measure the compile time of instantiating stubs.
+
+Generates translation units instantiating stub::function with 1 to 32
+arguments and return_handler::set_return(...) with 1 to 1000 values, and
+times the compiler front-end (-fsyntax-only) on each of them. The time of
+a translation unit only including the header is subtracted so the
+results show the cost of the instantiations.
+
+Usage:
+
+    python compile_benchmark.py --compiler c++ --include src --output build
+"""
+
+import argparse
+import os
+import subprocess
+import time
+
+ARITIES = [1, 2, 4, 8, 16, 32]
+RETURN_COUNTS = [1, 10, 100, 1000]
+STUBS_PER_UNIT = 20
+
+
+def arity_source(arity):
+    """Source instantiating STUBS_PER_UNIT stubs with arity arguments"""
+
+    lines = [
+        "#include <stub/function.hpp>",
+        "",
+        "#include <cstdint>",
+        "#include <iostream>",
+        "#include <type_traits>",
+        "",
+    ]
+
+    for stub in range(STUBS_PER_UNIT):
+        # Distinct argument types give distinct instantiations, the values
+        # convert to int when compared and printed
+        types = ", ".join(
+            "std::integral_constant<int, {}>".format(stub * 100 + i)
+            for i in range(arity)
+        )
+        values = ", ".join(
+            "std::integral_constant<int, {}>()".format(stub * 100 + i)
+            for i in range(arity)
+        )
+
+        lines += [
+            "bool use_{}()".format(stub),
+            "{",
+            "    stub::function<uint32_t({})> f;".format(types),
+            "    f.set_return(1U);",
+            "    f({});".format(values),
+            "    f.print(std::cout);",
+            "    return bool(f.expect_calls().with({}));".format(values),
+            "}",
+            "",
+        ]
+
+    return "\n".join(lines)
+
+
+def returns_source(count):
+    """Source calling set_return(...) with count values"""
+
+    values = ", ".join("{}U".format(i) for i in range(count))
+
+    return "\n".join(
+        [
+            "#include <stub/return_handler.hpp>",
+            "",
+            "#include <cstdint>",
+            "",
+            "void use()",
+            "{",
+            "    stub::return_handler<uint32_t> r;",
+            "    r.set_return({});".format(values),
+            "}",
+            "",
+        ]
+    )
+
+
+def empty_source(header):
+    """Source only including the header"""
+
+    return "\n".join(
+        [
+            "#include <stub/{}>".format(header),
+            "",
+            "#include <cstdint>",
+            "#include <iostream>",
+            "#include <type_traits>",
+            "",
+        ]
+    )
+
+
+def compile_time(args, name, source, repeat):
+    """Write the source and return the fastest of repeat compilations, or
+    None if the source does not compile"""
+
+    path = os.path.join(args.output, name + ".cpp")
+    with open(path, "w") as f:
+        f.write(source)
+
+    command = [args.compiler, "-std=c++14", "-fsyntax-only", "-I", args.include]
+    command += args.flags + [path]
+
+    best = None
+    for _ in range(repeat):
+        start = time.perf_counter()
+        if subprocess.call(command, stderr=subprocess.DEVNULL) != 0:
+            return None
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+
+    return best
+
+
+def print_result(size, elapsed, baseline):
+    """Print a row of the results"""
+
+    if elapsed is None:
+        print("{:>8} {:>12}".format(size, "failed"))
+    else:
+        print("{:>8} {:>12.3f}".format(size, elapsed - baseline))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--compiler", default="c++", help="The C++ compiler")
+    parser.add_argument("--include", required=True, help="The stub src dir")
+    parser.add_argument("--output", required=True, help="Directory for sources")
+    parser.add_argument("--repeat", type=int, default=3, help="Runs per unit")
+    parser.add_argument("flags", nargs="*", help="Extra compiler flags")
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.output):
+        os.makedirs(args.output)
+
+    baseline = compile_time(
+        args, "function", empty_source("function.hpp"), args.repeat
+    )
+    print("Including function.hpp: {:.3f} s".format(baseline))
+    print("{} stubs per unit".format(STUBS_PER_UNIT))
+    print("{:>8} {:>12}".format("arity", "time [s]"))
+    for arity in ARITIES:
+        elapsed = compile_time(
+            args, "arity_{}".format(arity), arity_source(arity), args.repeat
+        )
+        print_result(arity, elapsed, baseline)
+
+    print("")
+    baseline = compile_time(
+        args, "return_handler", empty_source("return_handler.hpp"), args.repeat
+    )
+    print("Including return_handler.hpp: {:.3f} s".format(baseline))
+    print("{:>8} {:>12}".format("returns", "time [s]"))
+    for count in RETURN_COUNTS:
+        elapsed = compile_time(
+            args, "returns_{}".format(count), returns_source(count), args.repeat
+        )
+        print_result(count, elapsed, baseline)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,221 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/function.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+/// Stream buffer discarding the written characters, used to measure the
+/// formatting without the cost of storing the text
+class null_streambuf : public std::streambuf
+{
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        return count;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        return traits_type::not_eof(c);
+    }
+};
+
+/// Number of calls recorded before the call log is cleared, such that the
+/// call recording benchmarks do not grow without bound
+const uint32_t max_calls = 1U << 16;
+}
+
+static void function_void(benchmark::State& state)
+{
+    stub::function<void()> function;
+
+    for (auto _ : state)
+    {
+        function();
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_void);
+
+static void function_uint32(benchmark::State& state)
+{
+    stub::function<void(uint32_t)> function;
+    uint32_t value = 0;
+
+    for (auto _ : state)
+    {
+        function(value++);
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_uint32);
+
+static void function_bool_return(benchmark::State& state)
+{
+    stub::function<bool(uint32_t, uint32_t)> function;
+    function.set_return(true, false);
+    uint32_t value = 0;
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(function(value, value + 1));
+        ++value;
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_bool_return);
+
+static void function_buffer(benchmark::State& state)
+{
+    stub::function<void(const uint8_t*, std::size_t)> function;
+    std::vector<uint8_t> buffer(1500);
+
+    for (auto _ : state)
+    {
+        function(buffer.data(), buffer.size());
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_buffer);
+
+static void function_string(benchmark::State& state)
+{
+    stub::function<void(const std::string&)> function;
+    std::string text((std::size_t)state.range(0), 'a');
+
+    for (auto _ : state)
+    {
+        function(text);
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_string)->Arg(8)->Arg(256);
+
+static void function_side_effect(benchmark::State& state)
+{
+    stub::function<void(uint32_t)> function;
+    uint64_t sum = 0;
+    function.add_side_effect([&sum](uint32_t value) { sum += value; });
+    uint32_t value = 0;
+
+    for (auto _ : state)
+    {
+        function(value++);
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+
+    benchmark::DoNotOptimize(sum);
+}
+BENCHMARK(function_side_effect);
+
+static void function_timing(benchmark::State& state)
+{
+    stub::function<void(uint32_t)> function;
+    function.enable_timing();
+    uint32_t value = 0;
+
+    for (auto _ : state)
+    {
+        function(value++);
+
+        if (function.calls() == max_calls)
+            function.clear_calls();
+    }
+}
+BENCHMARK(function_timing);
+
+static void expectation_to_bool(benchmark::State& state)
+{
+    const uint32_t calls = (uint32_t)state.range(0);
+
+    stub::function<void(uint32_t, uint32_t)> function;
+    auto expectation = function.expect_calls();
+
+    for (uint32_t i = 0; i < calls; ++i)
+    {
+        function(i, i * 2);
+        expectation.with(i, i * 2);
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(expectation.to_bool());
+    }
+
+    state.SetItemsProcessed(state.iterations() * calls);
+}
+BENCHMARK(expectation_to_bool)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+static void print_ostream(benchmark::State& state)
+{
+    const uint32_t calls = (uint32_t)state.range(0);
+
+    stub::function<void(uint32_t, const std::string&)> function;
+    for (uint32_t i = 0; i < calls; ++i)
+    {
+        function(i, "hello");
+    }
+
+    null_streambuf buffer;
+    std::ostream out(&buffer);
+
+    for (auto _ : state)
+    {
+        function.print(out);
+    }
+
+    state.SetItemsProcessed(state.iterations() * calls);
+}
+BENCHMARK(print_ostream)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void print_format_buffer(benchmark::State& state)
+{
+    const uint32_t calls = (uint32_t)state.range(0);
+
+    stub::function<void(uint32_t, const std::string&)> function;
+    for (uint32_t i = 0; i < calls; ++i)
+    {
+        function(i, "hello");
+    }
+
+    stub::format_buffer out;
+
+    for (auto _ : state)
+    {
+        out.clear();
+        function.print(out);
+    }
+
+    state.SetItemsProcessed(state.iterations() * calls);
+}
+BENCHMARK(print_format_buffer)
+    ->Arg(1000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,165 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/return_handler.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+/// The std::deque based return_handler used before the return values were
+/// stored contiguously. Kept here as a baseline for comparison.
+template <class R>
+class deque_return_handler
+{
+public:
+    void set_return(const std::vector<R>& values)
+    {
+        m_repeat = true;
+        m_position = 0;
+        m_returns.assign(values.begin(), values.end());
+    }
+
+    void no_repeat()
+    {
+        m_repeat = false;
+    }
+
+    R operator()() const
+    {
+        assert(m_returns.size() > 0);
+
+        if (m_repeat && (m_position == m_returns.size()))
+            m_position = 0;
+
+        assert(m_position < m_returns.size());
+
+        R value = m_returns.at(m_position);
+        ++m_position;
+
+        return value;
+    }
+
+private:
+    bool m_repeat = true;
+    mutable uint32_t m_position = 0;
+    std::deque<R> m_returns;
+};
+
+std::vector<uint32_t> make_values(uint32_t count)
+{
+    std::vector<uint32_t> values(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        values[i] = i;
+    }
+    return values;
+}
+}
+
+static void return_handler_deque_repeat(benchmark::State& state)
+{
+    deque_return_handler<uint32_t> handler;
+    handler.set_return(make_values((uint32_t)state.range(0)));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(handler());
+    }
+}
+BENCHMARK(return_handler_deque_repeat)->Arg(1)->Arg(8);
+
+static void return_handler_repeat(benchmark::State& state)
+{
+    stub::return_handler<uint32_t> handler;
+
+    switch (state.range(0))
+    {
+    case 1:
+        handler.set_return(0U);
+        break;
+    case 8:
+        handler.set_return(0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U);
+        break;
+    default:
+        state.SkipWithError("Unsupported number of return values");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(handler());
+    }
+}
+BENCHMARK(return_handler_repeat)->Arg(1)->Arg(8);
+
+static void return_handler_deque_bool(benchmark::State& state)
+{
+    deque_return_handler<bool> handler;
+    handler.set_return({true, false, true});
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(handler());
+    }
+}
+BENCHMARK(return_handler_deque_bool);
+
+static void return_handler_bool(benchmark::State& state)
+{
+    stub::return_handler<bool> handler;
+    handler.set_return(true, false, true);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(handler());
+    }
+}
+BENCHMARK(return_handler_bool);
+
+static void return_handler_no_repeat(benchmark::State& state)
+{
+    std::vector<uint32_t> values = make_values(1U << 16);
+
+    stub::return_handler<uint32_t> handler;
+    handler.set_return_range(values.begin(), values.end()).no_repeat();
+    std::size_t returned = 0;
+
+    for (auto _ : state)
+    {
+        if (returned == values.size())
+        {
+            state.PauseTiming();
+            handler.set_return_range(values.begin(), values.end()).no_repeat();
+            returned = 0;
+            state.ResumeTiming();
+        }
+
+        benchmark::DoNotOptimize(handler());
+        ++returned;
+    }
+}
+BENCHMARK(return_handler_no_repeat);
+
+static void return_handler_set_return(benchmark::State& state)
+{
+    stub::return_handler<uint32_t> handler;
+
+    for (auto _ : state)
+    {
+        handler.set_return(0U, 1U, 2U, 3U, 4U, 5U, 6U, 7U).no_repeat();
+
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            benchmark::DoNotOptimize(handler());
+        }
+    }
+}
+BENCHMARK(return_handler_set_return);
@@ -0,0 +1,8 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
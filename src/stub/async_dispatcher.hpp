@@ -0,0 +1,205 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace stub
+{
+/// @brief The async_dispatcher executes tasks on a background worker
+///        thread, e.g. used by the function object to run asynchronous
+///        side effects.
+///
+/// Tasks are added to a bounded queue and executed in order by the worker.
+/// If the queue is full, post(...) blocks until the worker has made room.
+/// Calling drain() waits until all posted tasks have been executed.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::async_dispatcher<std::function<void()>> dispatcher;
+///
+///        dispatcher.post([]() { write_to_fake_socket(); });
+///        dispatcher.post([]() { compute_checksum(); });
+///
+///        // Wait for both tasks to finish
+///        dispatcher.drain();
+///
+/// If a task throws an exception, the first exception is rethrown by
+/// drain(). Remaining tasks are executed when the async_dispatcher is
+/// destroyed.
+template <class Task>
+class async_dispatcher
+{
+public:
+    /// Constructor, starts the worker thread
+    ///
+    /// @param capacity The maximum number of tasks waiting in the queue
+    async_dispatcher(std::size_t capacity = 1024) :
+        m_capacity(capacity), m_busy(false), m_stop(false),
+        m_worker(&async_dispatcher::run, this)
+    {
+        assert(m_capacity > 0);
+    }
+
+    /// Destructor, executes the remaining tasks and stops the worker
+    ~async_dispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+
+        m_not_empty.notify_one();
+        m_worker.join();
+    }
+
+    /// Make the async_dispatcher non-copyable
+    async_dispatcher(const async_dispatcher&) = delete;
+    async_dispatcher& operator=(const async_dispatcher&) = delete;
+
+    /// Add a task to the queue. Blocks while the queue is full.
+    ///
+    /// @param task The task to execute on the worker thread
+    void post(Task task)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_full.wait(lock,
+                            [this]() { return m_tasks.size() < m_capacity; });
+
+            m_tasks.push_back(std::move(task));
+        }
+
+        m_not_empty.notify_one();
+    }
+
+    /// Wait until all posted tasks have been executed. Unlike drain() the
+    /// exceptions thrown by the tasks are kept for the next drain().
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]() { return m_tasks.empty() && !m_busy; });
+    }
+
+    /// Wait until all posted tasks have been executed. Rethrows the first
+    /// exception thrown by a task since the last call to drain().
+    void drain()
+    {
+        std::exception_ptr error;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idle.wait(lock,
+                        [this]() { return m_tasks.empty() && !m_busy; });
+
+            std::swap(error, m_error);
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /// @return The number of tasks waiting in the queue
+    std::size_t pending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_tasks.size();
+    }
+
+private:
+    /// The loop executed by the worker thread
+    void run()
+    {
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_not_empty.wait(lock,
+                             [this]() { return !m_tasks.empty() || m_stop; });
+
+            if (m_tasks.empty())
+            {
+                // We are stopping and all tasks have been executed
+                return;
+            }
+
+            Task task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            m_busy = true;
+
+            lock.unlock();
+            m_not_full.notify_one();
+
+            std::exception_ptr error;
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            m_busy = false;
+
+            if (error && !m_error)
+            {
+                m_error = error;
+            }
+
+            if (m_tasks.empty())
+            {
+                m_idle.notify_all();
+            }
+        }
+    }
+
+private:
+    /// The maximum number of tasks waiting in the queue
+    const std::size_t m_capacity;
+
+    /// The tasks waiting to be executed
+    std::deque<Task> m_tasks;
+
+    /// True while the worker executes a task
+    bool m_busy;
+
+    /// True when the worker should stop
+    bool m_stop;
+
+    /// The first exception thrown by a task
+    std::exception_ptr m_error;
+
+    /// Mutex protecting the state shared with the worker
+    mutable std::mutex m_mutex;
+
+    /// Signalled when a task is added or the worker should stop
+    std::condition_variable m_not_empty;
+
+    /// Signalled when a task is removed from the queue
+    std::condition_variable m_not_full;
+
+    /// Signalled when the queue is empty and the worker is idle
+    std::condition_variable m_idle;
+
+    /// The worker thread, declared last so it is started after the other
+    /// members have been initialized
+    std::thread m_worker;
+};
+}
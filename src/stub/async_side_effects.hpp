@@ -0,0 +1,135 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arguments.hpp"
+#include "async_dispatcher.hpp"
+#include "side_effect.hpp"
+
+namespace stub
+{
+/// @brief Worker invoking the asynchronous side effects of a function
+///        object on a background thread, see
+///        function::add_async_side_effect(...).
+///
+/// The header is opt-in since the worker thread pulls in <thread> and
+/// requires linking with the threads library, e.g. using the stub_async
+/// CMake target. Include it to use asynchronous side effects:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        #include <stub/async_side_effects.hpp>
+///
+///        stub::function<void(uint32_t)> send;
+///        send.add_async_side_effect([](uint32_t value) { ... });
+///
+/// The worker thread is started on the first call. The side effects are
+/// owned by the worker, so a pending call never refers to the function
+/// object.
+template <class... Args>
+class async_side_effects : public async_side_effects_interface<Args...>
+{
+    static_assert(std::is_copy_constructible<arguments<Args...>>::value,
+                  "Asynchronous side effects require copyable arguments");
+
+public:
+    void add(side_effect<Args...> effect) override
+    {
+        // The worker may be reading the side effects
+        drain();
+        m_side_effects.push_back(std::move(effect));
+    }
+
+    void post(const arguments<Args...>& call, uint32_t index) override
+    {
+        if (!m_dispatcher)
+        {
+            m_dispatcher.reset(new async_dispatcher<task>());
+        }
+
+        m_dispatcher->post(task{&m_side_effects, call, index});
+    }
+
+    void wait() override
+    {
+        if (m_dispatcher)
+        {
+            m_dispatcher->wait();
+        }
+    }
+
+    void drain() override
+    {
+        if (m_dispatcher)
+        {
+            m_dispatcher->drain();
+        }
+    }
+
+    std::unique_ptr<async_side_effects_interface<Args...>> clone() override
+    {
+        // The worker may be invoking the side effects
+        wait();
+
+        std::unique_ptr<async_side_effects> copy(new async_side_effects());
+        copy->m_side_effects = m_side_effects;
+
+        return std::unique_ptr<async_side_effects_interface<Args...>>(
+            copy.release());
+    }
+
+    std::size_t memory_usage() const override
+    {
+        std::size_t usage =
+            m_side_effects.capacity() * sizeof(side_effect<Args...>);
+
+        for (const auto& side_effect : m_side_effects)
+        {
+            usage += side_effect.heap_size();
+        }
+
+        return usage;
+    }
+
+private:
+    /// Task invoking the side effects for a call
+    struct task
+    {
+        void operator()() const
+        {
+            for (const auto& side_effect : *m_side_effects)
+            {
+                side_effect(m_call, m_index);
+            }
+        }
+
+        /// The side effects
+        const std::vector<side_effect<Args...>>* m_side_effects;
+
+        /// Copy of the arguments of the call
+        arguments<Args...> m_call;
+
+        /// The index of the call
+        uint32_t m_index;
+    };
+
+private:
+    /// The side effects invoked for every call
+    std::vector<side_effect<Args...>> m_side_effects;
+
+    /// The dispatcher running the worker thread. Declared last so the
+    /// pending tasks finish before the side effects are destroyed.
+    std::unique_ptr<async_dispatcher<task>> m_dispatcher;
+};
+}
@@ -0,0 +1,420 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "function.hpp"
+#include "trace.hpp"
+
+namespace stub
+{
+/// Stream buffer computing the 64 bit FNV-1a hash of the written bytes
+class fnv1a_streambuf : public std::streambuf
+{
+public:
+    /// @return The initial value of the hash
+    static uint64_t offset_basis()
+    {
+        return 14695981039346656037ULL;
+    }
+
+    /// Constructor
+    fnv1a_streambuf() : m_hash(offset_basis())
+    {
+        setp(m_buffer, m_buffer + sizeof(m_buffer));
+    }
+
+    /// Make the fnv1a_streambuf non-copyable
+    fnv1a_streambuf(const fnv1a_streambuf&) = delete;
+    fnv1a_streambuf& operator=(const fnv1a_streambuf&) = delete;
+
+    /// @return The hash of the bytes written so far
+    uint64_t hash()
+    {
+        consume();
+        return m_hash;
+    }
+
+    /// Set the hash, e.g. to restart hashing from the offset basis
+    void set_hash(uint64_t hash)
+    {
+        consume();
+        m_hash = hash;
+    }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        consume();
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+            update((uint8_t)traits_type::to_char_type(c));
+
+        return traits_type::not_eof(c);
+    }
+
+private:
+    /// Hash the bytes in the put area and empty it
+    void consume()
+    {
+        for (char* c = pbase(); c != pptr(); ++c)
+        {
+            update((uint8_t)*c);
+        }
+        setp(m_buffer, m_buffer + sizeof(m_buffer));
+    }
+
+    void update(uint8_t byte)
+    {
+        m_hash = (m_hash ^ byte) * 1099511628211ULL;
+    }
+
+private:
+    /// The hash of the consumed bytes
+    uint64_t m_hash;
+
+    /// The put area
+    char m_buffer[256];
+};
+
+/// @brief Hashes over the calls recorded by a function object, used to
+///        compare call logs, e.g. against a golden log from a previous
+///        release.
+///
+/// The calls are encoded as in a binary trace (see write_trace(...)) and
+/// hashed using 64 bit FNV-1a, so the hashes are stable across platforms
+/// and runs (except for pointer values). The log is divided into segments
+/// of segment_size calls, and for each segment the digest stores the hash
+/// of the segment and the hash of all calls up to and including the
+/// segment (the prefix hash).
+///
+/// Comparing two digests is O(1) using the hash of the whole log. If the
+/// logs differ, the first differing segment is located by a binary search
+/// over the prefix hashes.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::call_digest current(my_func);
+///
+///        std::ifstream file("golden.digest", std::ios::binary);
+///        auto golden = stub::call_digest::load(file);
+///
+///        if (current != golden)
+///        {
+///            uint32_t segment = current.first_difference(golden);
+///            uint32_t first_call = segment * current.segment_size();
+///
+///            // Print the calls of the differing segment
+///            my_func.print_calls(std::cout, first_call,
+///                                first_call + current.segment_size());
+///        }
+///
+class call_digest
+{
+public:
+    /// Construct an empty digest
+    ///
+    /// @param segment_size The number of calls per segment
+    call_digest(uint32_t segment_size = 1024) :
+        m_segment_size(segment_size), m_calls(0), m_types_hash(0),
+        m_output(m_hash)
+    {
+        assert(m_segment_size > 0);
+    }
+
+    /// Construct a digest of the calls recorded by a function object
+    ///
+    /// @param function The function object whose calls are hashed
+    /// @param segment_size The number of calls per segment
+    template <class R, class... Args>
+    call_digest(const function<R(Args...)>& function,
+                uint32_t segment_size = 1024) :
+        call_digest(segment_size)
+    {
+        set_types(trace_types<Args...>());
+
+        for (uint32_t i = 0; i < function.calls(); ++i)
+        {
+            add(function.call_arguments(i));
+        }
+    }
+
+    /// Copy constructor
+    call_digest(const call_digest& other) :
+        m_segment_size(other.m_segment_size), m_calls(other.m_calls),
+        m_types_hash(other.m_types_hash), m_segments(other.m_segments),
+        m_prefixes(other.m_prefixes), m_output(m_hash)
+    {
+        // The hash of the current segment is stored after each call
+        if (!m_segments.empty())
+            m_hash.set_hash(m_segments.back());
+    }
+
+    /// Copy assignment
+    call_digest& operator=(const call_digest& other)
+    {
+        m_segment_size = other.m_segment_size;
+        m_calls = other.m_calls;
+        m_types_hash = other.m_types_hash;
+        m_segments = other.m_segments;
+        m_prefixes = other.m_prefixes;
+        m_hash.set_hash(m_segments.empty() ? fnv1a_streambuf::offset_basis()
+                                           : m_segments.back());
+        return *this;
+    }
+
+    /// Set the types of the arguments, which are included in the
+    /// comparison
+    ///
+    /// @param types The types of the arguments, see trace_types()
+    void set_types(const std::vector<std::string>& types)
+    {
+        fnv1a_streambuf hash;
+        trace_output output(hash);
+
+        for (const auto& type : types)
+        {
+            output.write_varint(type.size());
+            output.write_bytes((const uint8_t*)type.data(), type.size());
+        }
+
+        m_types_hash = hash.hash();
+    }
+
+    /// Add a call to the digest
+    ///
+    /// @param call The arguments of the call
+    template <class... T>
+    void add(const std::tuple<T...>& call)
+    {
+        if (m_calls % m_segment_size == 0)
+        {
+            // Start a new segment
+            m_hash.set_hash(fnv1a_streambuf::offset_basis());
+            m_segments.push_back(0);
+            m_prefixes.push_back(0);
+        }
+
+        write_trace_call(m_output, call);
+        ++m_calls;
+
+        // The prefix hash chains the segment hash onto the previous prefix
+        uint64_t segment = m_hash.hash();
+        m_segments.back() = segment;
+        m_prefixes.back() = combine(previous_prefix(), segment);
+    }
+
+    /// @return The number of calls per segment
+    uint32_t segment_size() const
+    {
+        return m_segment_size;
+    }
+
+    /// @return The number of calls
+    uint64_t calls() const
+    {
+        return m_calls;
+    }
+
+    /// @return The number of segments
+    uint32_t segments() const
+    {
+        return (uint32_t)m_segments.size();
+    }
+
+    /// @return The hash of the segment with the given index
+    uint64_t segment_hash(uint32_t index) const
+    {
+        assert(index < m_segments.size());
+        return m_segments[index];
+    }
+
+    /// @return The hash of all calls up to and including the segment
+    uint64_t prefix_hash(uint32_t index) const
+    {
+        assert(index < m_prefixes.size());
+        return m_prefixes[index];
+    }
+
+    /// @return The hash of the types and all calls
+    uint64_t hash() const
+    {
+        return combine(m_types_hash, m_prefixes.empty()
+                                         ? fnv1a_streambuf::offset_basis()
+                                         : m_prefixes.back());
+    }
+
+    /// Find the first segment which differs from the other digest using a
+    /// binary search over the prefix hashes. Both digests must use the
+    /// same segment size.
+    ///
+    /// @param other The digest to compare with
+    ///
+    /// @return The index of the first differing segment, or segments() if
+    ///         the digests are equal
+    uint32_t first_difference(const call_digest& other) const
+    {
+        assert(m_segment_size == other.m_segment_size);
+
+        if (m_types_hash != other.m_types_hash)
+            return 0;
+
+        uint32_t low = 0;
+        uint32_t high = std::min(segments(), other.segments());
+
+        // Invariant: segments before low are equal, high differs or is
+        // past the end of the shorter log
+        while (low < high)
+        {
+            uint32_t middle = low + (high - low) / 2;
+
+            if (m_prefixes[middle] == other.m_prefixes[middle])
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        if (low == segments() && low == other.segments())
+            return segments();
+
+        return low;
+    }
+
+    /// Write the digest, e.g. to store it as a golden digest file
+    ///
+    /// @param out The stream where the digest is written
+    void save(std::ostream& out) const
+    {
+        trace_output output(*out.rdbuf());
+
+        output.write_bytes(digest_magic(), 8);
+        output.write_varint(m_segment_size);
+        output.write_varint(m_calls);
+        output.write_fixed(m_types_hash, 8);
+        output.write_varint(m_segments.size());
+
+        for (std::size_t i = 0; i < m_segments.size(); ++i)
+        {
+            output.write_fixed(m_segments[i], 8);
+            output.write_fixed(m_prefixes[i], 8);
+        }
+    }
+
+    /// Read a digest written by save(...). A trace_error is thrown if the
+    /// digest is invalid.
+    ///
+    /// @param in The stream from where the digest is read
+    ///
+    /// @return The digest
+    static call_digest load(std::istream& in)
+    {
+        trace_input input(*in.rdbuf());
+
+        uint8_t magic[8];
+        input.read_bytes(magic, sizeof(magic));
+
+        if (!std::equal(magic, magic + sizeof(magic), digest_magic()))
+            throw trace_error("Not a digest or unsupported digest version");
+
+        uint64_t segment_size = input.read_varint();
+        if (segment_size == 0 || segment_size > UINT32_MAX)
+            throw trace_error("Invalid segment size in the digest");
+
+        call_digest digest((uint32_t)segment_size);
+        digest.m_calls = input.read_varint();
+        digest.m_types_hash = input.read_fixed(8);
+
+        uint64_t segments = input.read_varint();
+        if (segments != (digest.m_calls + segment_size - 1) / segment_size)
+            throw trace_error("Invalid number of segments in the digest");
+
+        for (uint64_t i = 0; i < segments; ++i)
+        {
+            digest.m_segments.push_back(input.read_fixed(8));
+            digest.m_prefixes.push_back(input.read_fixed(8));
+        }
+
+        // Continue the current segment when more calls are added
+        if (!digest.m_segments.empty())
+            digest.m_hash.set_hash(digest.m_segments.back());
+
+        return digest;
+    }
+
+    /// @return True if the digests contain the same calls
+    bool operator==(const call_digest& other) const
+    {
+        return m_calls == other.m_calls && hash() == other.hash();
+    }
+
+    /// @return True if the digests contain different calls
+    bool operator!=(const call_digest& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    /// @return The bytes starting a digest file
+    static const uint8_t* digest_magic()
+    {
+        static const uint8_t magic[] = {'S', 'T', 'U', 'B', 'D', 'G', 'S', 1};
+        return magic;
+    }
+
+    /// Combine two hashes
+    static uint64_t combine(uint64_t first, uint64_t second)
+    {
+        fnv1a_streambuf hash;
+        trace_output output(hash);
+        output.write_fixed(first, 8);
+        output.write_fixed(second, 8);
+        return hash.hash();
+    }
+
+    /// @return The prefix hash of the segments before the current one
+    uint64_t previous_prefix() const
+    {
+        if (m_prefixes.size() < 2)
+            return fnv1a_streambuf::offset_basis();
+
+        return m_prefixes[m_prefixes.size() - 2];
+    }
+
+private:
+    /// The number of calls per segment
+    uint32_t m_segment_size;
+
+    /// The number of calls
+    uint64_t m_calls;
+
+    /// The hash of the argument types
+    uint64_t m_types_hash;
+
+    /// The hash of each segment
+    std::vector<uint64_t> m_segments;
+
+    /// The hash of all calls up to and including each segment
+    std::vector<uint64_t> m_prefixes;
+
+    /// Hashes the calls of the current segment
+    fnv1a_streambuf m_hash;
+
+    /// Output encoding the calls into m_hash
+    trace_output m_output;
+};
+}
@@ -0,0 +1,263 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace stub
+{
+/// @brief Histogram of durations in nanoseconds with log-linear buckets,
+///        similar to an HDR histogram.
+///
+/// Values below 32 have a bucket each. Larger values are divided into 16
+/// buckets per power of two, so a value is reported with a relative error
+/// of at most 1/16 (6.25%) while the histogram covers the full range of
+/// uint64_t using a fixed number of buckets. The buckets are allocated when
+/// the first value is recorded.
+class gap_histogram
+{
+public:
+    /// The number of buckets
+    static const uint32_t bucket_count = 32 + 59 * 16;
+
+    /// Constructor
+    gap_histogram() :
+        m_count(0), m_sum(0), m_min(std::numeric_limits<uint64_t>::max()),
+        m_max(0)
+    {
+    }
+
+    /// Record a value
+    ///
+    /// @param value The value to record
+    void record(uint64_t value)
+    {
+        if (m_buckets.empty())
+            m_buckets.resize((std::size_t)bucket_count);
+
+        ++m_buckets[bucket_index(value)];
+        ++m_count;
+        m_sum += value;
+        m_min = value < m_min ? value : m_min;
+        m_max = value > m_max ? value : m_max;
+    }
+
+    /// Remove all recorded values
+    void clear()
+    {
+        *this = gap_histogram();
+    }
+
+    /// @return The number of recorded values
+    uint64_t count() const
+    {
+        return m_count;
+    }
+
+    /// @return The smallest recorded value, zero if no values are recorded
+    uint64_t min() const
+    {
+        return m_count == 0 ? 0 : m_min;
+    }
+
+    /// @return The largest recorded value
+    uint64_t max() const
+    {
+        return m_max;
+    }
+
+    /// @return The mean of the recorded values
+    uint64_t mean() const
+    {
+        return m_count == 0 ? 0 : m_sum / m_count;
+    }
+
+    /// @return The number of bytes held by the buckets
+    std::size_t memory_usage() const
+    {
+        return m_buckets.capacity() * sizeof(uint64_t);
+    }
+
+    /// @param percentile The percentile in the range [0, 100]
+    ///
+    /// @return The value below which the given percentage of the recorded
+    ///         values fall, rounded up to the end of its bucket
+    uint64_t value_at_percentile(double percentile) const
+    {
+        assert(percentile >= 0.0 && percentile <= 100.0);
+
+        if (m_count == 0)
+            return 0;
+
+        // The rank is rounded up, so e.g. the 99th percentile of three
+        // values is the largest value
+        uint64_t target =
+            (uint64_t)std::ceil(percentile / 100.0 * (double)m_count);
+        target = target == 0 ? 1 : target;
+
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < bucket_count; ++i)
+        {
+            seen += m_buckets[i];
+
+            if (seen >= target)
+            {
+                uint64_t value = bucket_highest(i);
+                return value < m_max ? value : m_max;
+            }
+        }
+
+        return m_max;
+    }
+
+    /// @return The index of the bucket holding the value
+    static uint32_t bucket_index(uint64_t value)
+    {
+        if (value < 32)
+            return (uint32_t)value;
+
+        // Find the most significant bit
+        uint32_t msb = 0;
+        for (uint32_t shift = 32; shift != 0; shift /= 2)
+        {
+            if ((value >> (msb + shift)) != 0)
+                msb += shift;
+        }
+
+        uint32_t shift = msb - 4;
+        return 32 + (msb - 5) * 16 + (uint32_t)((value >> shift) - 16);
+    }
+
+    /// @return The largest value held by the bucket
+    static uint64_t bucket_highest(uint32_t index)
+    {
+        if (index < 32)
+            return index;
+
+        uint32_t msb = (index - 32) / 16 + 5;
+        uint64_t sub_bucket = (index - 32) % 16 + 16;
+        uint32_t shift = msb - 4;
+
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+private:
+    /// The number of values in each bucket
+    std::vector<uint64_t> m_buckets;
+
+    /// The number of recorded values
+    uint64_t m_count;
+
+    /// The sum of the recorded values
+    uint64_t m_sum;
+
+    /// The smallest recorded value
+    uint64_t m_min;
+
+    /// The largest recorded value
+    uint64_t m_max;
+};
+
+/// @brief Timestamps of the calls made to a function object and a
+///        histogram of the gaps between them, see
+///        function::enable_timing().
+///
+/// The timestamps are taken from std::chrono::steady_clock, which is
+/// monotonic.
+class call_timing
+{
+public:
+    /// The clock used for the timestamps
+    using clock = std::chrono::steady_clock;
+
+    /// Constructor
+    call_timing() : m_enabled(false)
+    {
+    }
+
+    /// @return True if calls are timed otherwise false
+    bool enabled() const
+    {
+        return m_enabled;
+    }
+
+    /// Start or stop timing the calls
+    void set_enabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    /// Record the time of a call
+    void record(clock::time_point time)
+    {
+        if (!m_timestamps.empty())
+        {
+            auto gap = time - m_timestamps.back();
+            m_gaps.record((uint64_t)std::chrono::duration_cast<
+                              std::chrono::nanoseconds>(gap)
+                              .count());
+        }
+
+        m_timestamps.push_back(time);
+    }
+
+    /// Remove the timestamps and the gaps
+    void clear()
+    {
+        m_timestamps.clear();
+        m_gaps.clear();
+    }
+
+    /// @return The number of timed calls
+    uint32_t calls() const
+    {
+        return (uint32_t)m_timestamps.size();
+    }
+
+    /// @return The time of a call
+    clock::time_point timestamp(uint32_t index) const
+    {
+        assert(index < m_timestamps.size());
+        return m_timestamps[index];
+    }
+
+    /// @return The time of a call relative to the first call
+    std::chrono::nanoseconds elapsed(uint32_t index) const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timestamp(index) - timestamp(0));
+    }
+
+    /// @return The number of bytes held by the timestamps and the gaps
+    std::size_t memory_usage() const
+    {
+        return m_timestamps.capacity() * sizeof(clock::time_point) +
+               m_gaps.memory_usage();
+    }
+
+    /// @return The histogram of the gaps between calls in nanoseconds
+    const gap_histogram& gaps() const
+    {
+        return m_gaps;
+    }
+
+private:
+    /// True if calls are timed
+    bool m_enabled;
+
+    /// The time of each call
+    std::vector<clock::time_point> m_timestamps;
+
+    /// The gaps between calls in nanoseconds
+    gap_histogram m_gaps;
+};
+}
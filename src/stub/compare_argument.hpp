@@ -14,6 +14,33 @@
 
 namespace stub
 {
+/// Trait telling whether a type is a matcher i.e. a special value with a
+/// compare_argument(...) overload, rather than a value compared using
+/// operator==. Specialize this for custom matchers to use them in rules,
+/// see function::when(...).
+template <class T>
+struct is_matcher : std::false_type
+{
+};
+
+/// ignore is a matcher
+template <>
+struct is_matcher<ignore> : std::true_type
+{
+};
+
+/// not_nullptr is a matcher
+template <>
+struct is_matcher<not_nullptr> : std::true_type
+{
+};
+
+/// compare is a matcher
+template <class Compare>
+struct is_matcher<compare<Compare>> : std::true_type
+{
+};
+
 /// Compares two arguments of same type
 template <class T, class U>
 inline bool compare_argument(T a, U b)
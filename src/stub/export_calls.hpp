@@ -0,0 +1,518 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "format_buffer.hpp"
+#include "function.hpp"
+#include "print_arguments.hpp"
+#include "print_value.hpp"
+
+namespace stub
+{
+/// Options controlling which fields are added to the exported calls, see
+/// write_json_lines(...) and write_csv(...).
+struct export_options
+{
+    /// Add the index of the call as the "index" field
+    bool m_index = false;
+
+    /// Add the time of the call in nanoseconds relative to the first call
+    /// as the "timestamp" field. Only used if timing is enabled on the
+    /// function object, see function::enable_timing().
+    bool m_timestamp = false;
+};
+
+/// Tags used to select how a value is exported
+struct export_as_bool
+{
+};
+struct export_as_character
+{
+};
+struct export_as_integer
+{
+};
+struct export_as_floating_point
+{
+};
+struct export_as_enum
+{
+};
+struct export_as_pointer
+{
+};
+struct export_as_text
+{
+};
+struct export_as_bytes
+{
+};
+struct export_as_array
+{
+};
+struct export_as_streamed
+{
+};
+
+/// Select how a value is exported. Strings, characters, pointers, byte
+/// buffers and values written using operator<< are exported as strings,
+/// ranges as arrays and numbers as numbers.
+template <class T>
+using export_category = typename std::conditional<
+    std::is_same<T, bool>::value, export_as_bool,
+    typename std::conditional<
+        std::is_same<T, char>::value, export_as_character,
+        typename std::conditional<
+            std::is_integral<T>::value, export_as_integer,
+            typename std::conditional<
+                std::is_floating_point<T>::value, export_as_floating_point,
+                typename std::conditional<
+                    std::is_enum<T>::value, export_as_enum,
+                    typename std::conditional<
+                        std::is_pointer<T>::value, export_as_pointer,
+                        typename std::conditional<
+                            std::is_same<print_category<T>,
+                                         print_as_text>::value,
+                            export_as_text,
+                            typename std::conditional<
+                                std::is_same<print_category<T>,
+                                             print_as_bytes>::value,
+                                export_as_bytes,
+                                typename std::conditional<
+                                    std::is_same<print_category<T>,
+                                                 print_as_range>::value,
+                                    export_as_array,
+                                    export_as_streamed>::type>::type>::
+                            type>::type>::type>::type>::type>::type>::type;
+
+/// @return True if the category is exported as a string
+template <class Category>
+using is_export_string = std::integral_constant<
+    bool, std::is_same<Category, export_as_character>::value ||
+              std::is_same<Category, export_as_pointer>::value ||
+              std::is_same<Category, export_as_text>::value ||
+              std::is_same<Category, export_as_bytes>::value ||
+              std::is_same<Category, export_as_streamed>::value>;
+
+/// Append a string escaped for use inside a JSON string
+inline void append_json_escaped(format_buffer& out, const char* data,
+                                std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        char c = data[i];
+        switch (c)
+        {
+        case '"':
+            out.append("\\\"");
+            break;
+        case '\\':
+            out.append("\\\\");
+            break;
+        case '\n':
+            out.append("\\n");
+            break;
+        case '\r':
+            out.append("\\r");
+            break;
+        case '\t':
+            out.append("\\t");
+            break;
+        default:
+            if ((uint8_t)c < 0x20)
+            {
+                out.append("\\u00");
+                out.append("0123456789abcdef"[(uint8_t)c >> 4]);
+                out.append("0123456789abcdef"[(uint8_t)c & 0xf]);
+            }
+            else
+            {
+                out.append(c);
+            }
+        }
+    }
+}
+
+/// Export a value, see the definition below
+template <class T>
+inline void export_value(format_buffer& out, const T& value);
+
+/// Export the content of a string value without quotes
+template <class T>
+inline void export_string(format_buffer& out, const T& value,
+                          export_as_character)
+{
+    out.append(value);
+}
+
+template <class T>
+inline void export_string(format_buffer& out, const T& value,
+                          export_as_pointer)
+{
+    out.append_hex((uintptr_t)value);
+}
+
+template <class T>
+inline void export_string(format_buffer& out, const T& value, export_as_text)
+{
+    out.append((const char*)value.data(), value.size());
+}
+
+template <class T>
+inline void export_string(format_buffer& out, const T& value, export_as_bytes)
+{
+    print_hex(out, (const uint8_t*)value.data(), value.size());
+}
+
+template <class T>
+inline void export_string(format_buffer& out, const T& value,
+                          export_as_streamed)
+{
+    out.stream() << value;
+}
+
+/// Export a bool
+template <class T>
+inline void export_value(format_buffer& out, const T& value, export_as_bool)
+{
+    if (value)
+        out.append("true");
+    else
+        out.append("false");
+}
+
+/// Export an integer
+template <class T>
+inline void export_value(format_buffer& out, const T& value,
+                         export_as_integer)
+{
+    // Promote character types such as uint8_t so they are written as numbers
+    out.append_value(+value);
+}
+
+/// Export a floating point value, JSON has no representation of infinity
+/// and NaN so they are exported as null
+template <class T>
+inline void export_value(format_buffer& out, const T& value,
+                         export_as_floating_point)
+{
+    if (std::isfinite(value))
+        out.append_exact(value);
+    else
+        out.append("null");
+}
+
+/// Export an enumeration as the underlying integer
+template <class T>
+inline void export_value(format_buffer& out, const T& value, export_as_enum)
+{
+    using underlying_type = typename std::underlying_type<T>::type;
+    export_value(out, (underlying_type)value);
+}
+
+/// Export a range as an array
+template <class T>
+inline void export_value(format_buffer& out, const T& value, export_as_array)
+{
+    out.append('[');
+
+    bool first = true;
+    for (const auto& element : value)
+    {
+        if (!first)
+            out.append(',');
+
+        export_value(out, element);
+        first = false;
+    }
+
+    out.append(']');
+}
+
+/// Export a value as a JSON string
+template <class T, class Category>
+inline void export_value(format_buffer& out, const T& value, Category category)
+{
+    static_assert(is_export_string<Category>::value, "Unexpected category");
+
+    // Format the content first so it can be escaped
+    format_buffer content;
+    export_string(content, value, category);
+
+    out.append('"');
+    append_json_escaped(out, content.data(), content.size());
+    out.append('"');
+}
+
+/// Export a value as JSON:
+///
+///   - bool is exported as true or false.
+///   - Integers, floating point values and enumerations are exported as
+///     numbers, infinite floating point values and NaN as null.
+///   - Strings and characters are exported as strings.
+///   - Pointers are exported as strings with the value in hex.
+///   - Byte buffers, e.g. std::vector<uint8_t>, are exported as strings
+///     with the bytes in hex.
+///   - Ranges, e.g. std::vector<uint32_t>, are exported as arrays.
+///   - Other values are exported as strings written using operator<<.
+///
+/// @param out The format_buffer where the value is written
+/// @param value The value to export
+template <class T>
+inline void export_value(format_buffer& out, const T& value)
+{
+    export_value(out, value, export_category<T>());
+}
+
+/// Append a field to a CSV record, quoting it if needed
+inline void append_csv_field(format_buffer& out, const char* data,
+                             std::size_t size)
+{
+    bool quote = false;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        char c = data[i];
+        quote = quote || c == ',' || c == '"' || c == '\n' || c == '\r';
+    }
+
+    if (!quote)
+    {
+        out.append(data, size);
+        return;
+    }
+
+    out.append('"');
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (data[i] == '"')
+            out.append('"');
+        out.append(data[i]);
+    }
+    out.append('"');
+}
+
+/// Writes the arguments of a call as the fields of a JSON object, used
+/// with print_arguments(...) to iterate over the arguments
+struct json_record
+{
+    /// The buffer where the record is written
+    format_buffer& m_buffer;
+
+    /// True if no field has been written yet
+    bool m_first;
+};
+
+/// Writes the arguments of a call as the fields of a CSV record, used
+/// with print_arguments(...) to iterate over the arguments
+struct csv_record
+{
+    /// The buffer where the record is written
+    format_buffer& m_buffer;
+
+    /// True if no field has been written yet
+    bool m_first;
+
+    /// Buffer used to format a field before it is quoted
+    format_buffer& m_field;
+};
+
+/// Write an argument as the field "arg<index>" of a JSON object
+template <class T>
+inline void print_argument(json_record& out, uint32_t index, const T& value)
+{
+    if (!out.m_first)
+        out.m_buffer.append(',');
+
+    out.m_buffer.append("\"arg");
+    out.m_buffer.append_value(index);
+    out.m_buffer.append("\":");
+    export_value(out.m_buffer, value);
+    out.m_first = false;
+}
+
+/// Write the content of a string without quotes
+template <class T>
+inline void export_csv_value(format_buffer& out, const T& value,
+                             std::true_type)
+{
+    export_string(out, value, export_category<T>());
+}
+
+/// Write other values as JSON
+template <class T>
+inline void export_csv_value(format_buffer& out, const T& value,
+                             std::false_type)
+{
+    export_value(out, value);
+}
+
+/// Write an argument as a field of a CSV record. Strings are written
+/// without JSON quotes and ranges as JSON arrays.
+template <class T>
+inline void print_argument(csv_record& out, uint32_t index, const T& value)
+{
+    (void)index;
+
+    if (!out.m_first)
+        out.m_buffer.append(',');
+
+    out.m_field.clear();
+    export_csv_value(out.m_field, value,
+                     is_export_string<export_category<T>>());
+    append_csv_field(out.m_buffer, out.m_field.data(), out.m_field.size());
+    out.m_first = false;
+}
+
+/// Write the calls of a function object as JSON Lines, i.e. one JSON
+/// object per line with the fields "arg0", "arg1", ... holding the
+/// arguments of the call, optionally preceded by "index" and "timestamp".
+/// See export_value(...) for how the arguments are exported.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::function<void(uint32_t, std::string)> my_func;
+///
+///        my_func(4U, "hello");
+///
+///        stub::export_options options;
+///        options.m_index = true;
+///
+///        // Writes {"index":0,"arg0":4,"arg1":"hello"}
+///        stub::write_json_lines(std::cout, my_func, options);
+///
+/// The output is written to the stream in chunks so the memory used is
+/// bounded.
+///
+/// @param out The stream where the calls are written
+/// @param function The function object whose calls are written
+/// @param options The additional fields to write
+template <class R, class... Args>
+inline void write_json_lines(std::ostream& out,
+                             const function<R(Args...)>& function,
+                             const export_options& options = export_options())
+{
+    format_buffer buffer;
+    bool timestamps = options.m_timestamp && function.timing().enabled();
+
+    for (uint32_t i = 0; i < function.calls(); ++i)
+    {
+        json_record record{buffer, true};
+        buffer.append('{');
+
+        if (options.m_index)
+        {
+            buffer.append("\"index\":");
+            buffer.append_value(i);
+            record.m_first = false;
+        }
+
+        if (timestamps)
+        {
+            if (!record.m_first)
+                buffer.append(',');
+
+            buffer.append("\"timestamp\":");
+            buffer.append_value(function.timing().elapsed(i).count());
+            record.m_first = false;
+        }
+
+        print_arguments(record, function.call_arguments(i));
+        buffer.append("}\n");
+
+        if (buffer.size() >= 65536)
+        {
+            buffer.write_to(out);
+            buffer.clear();
+        }
+    }
+
+    buffer.write_to(out);
+}
+
+/// Write the calls of a function object as CSV with a header line naming
+/// the columns "arg0", "arg1", ... followed by one line per call. Strings
+/// are written as text, ranges as JSON arrays and other values as in
+/// write_json_lines(...). Fields are quoted as described in RFC 4180.
+///
+/// @param out The stream where the calls are written
+/// @param function The function object whose calls are written
+/// @param options The additional columns to write
+template <class R, class... Args>
+inline void write_csv(std::ostream& out, const function<R(Args...)>& function,
+                      const export_options& options = export_options())
+{
+    format_buffer buffer;
+    format_buffer field;
+    bool timestamps = options.m_timestamp && function.timing().enabled();
+
+    bool first = true;
+    if (options.m_index)
+    {
+        buffer.append("index");
+        first = false;
+    }
+
+    if (timestamps)
+    {
+        if (!first)
+            buffer.append(',');
+
+        buffer.append("timestamp");
+        first = false;
+    }
+
+    for (uint32_t i = 0; i < sizeof...(Args); ++i)
+    {
+        if (!first)
+            buffer.append(',');
+
+        buffer.append("arg");
+        buffer.append_value(i);
+        first = false;
+    }
+    buffer.append('\n');
+
+    for (uint32_t i = 0; i < function.calls(); ++i)
+    {
+        csv_record record{buffer, true, field};
+
+        if (options.m_index)
+        {
+            buffer.append_value(i);
+            record.m_first = false;
+        }
+
+        if (timestamps)
+        {
+            if (!record.m_first)
+                buffer.append(',');
+
+            buffer.append_value(function.timing().elapsed(i).count());
+            record.m_first = false;
+        }
+
+        print_arguments(record, function.call_arguments(i));
+        buffer.append('\n');
+
+        if (buffer.size() >= 65536)
+        {
+            buffer.write_to(out);
+            buffer.clear();
+        }
+    }
+
+    buffer.write_to(out);
+}
+}
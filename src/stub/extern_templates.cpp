@@ -0,0 +1,22 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include "extern_templates.hpp"
+
+namespace stub
+{
+// Explicit instantiation definitions matching the declarations in
+// extern_templates.hpp
+template class function<void()>;
+template class function<void(uint32_t)>;
+template class function<bool()>;
+template class function<void(const uint8_t*, std::size_t)>;
+
+template class return_handler<bool>;
+
+template struct compare_call<>;
+template struct compare_call<uint32_t>;
+template struct compare_call<const uint8_t*, std::size_t>;
+}
@@ -0,0 +1,35 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "function.hpp"
+
+namespace stub
+{
+/// Explicit instantiation declarations of the function objects with the
+/// most common signatures. When STUB_EXTERN_TEMPLATES is defined these are
+/// included by function.hpp, and the instantiations are compiled once in
+/// extern_templates.cpp instead of in every translation unit using them.
+/// With CMake, link with the stub_instantiations target which defines
+/// STUB_EXTERN_TEMPLATES. The target is only built when used, and with waf
+/// it is only defined when stub is the top-level project.
+///
+/// The list must match the explicit instantiation definitions in
+/// extern_templates.cpp.
+extern template class function<void()>;
+extern template class function<void(uint32_t)>;
+extern template class function<bool()>;
+extern template class function<void(const uint8_t*, std::size_t)>;
+
+extern template class return_handler<bool>;
+
+extern template struct compare_call<>;
+extern template struct compare_call<uint32_t>;
+extern template struct compare_call<const uint8_t*, std::size_t>;
+}
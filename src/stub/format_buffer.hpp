@@ -0,0 +1,313 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <ostream>
+#include <streambuf>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+namespace stub
+{
+/// @brief Growing character buffer used to format text before writing it
+///        to a std::ostream in one go.
+///
+/// Integers and floating point values are formatted directly into the
+/// buffer, using std::to_chars when available, producing the same text as
+/// the default formatting of std::ostream. Other values are written
+/// through stream(), a std::ostream writing into the buffer, so any type
+/// with an output operator can be formatted.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::format_buffer buffer;
+///
+///        buffer.append("Arg ");
+///        buffer.append_value(4U);
+///        buffer.append('\n');
+///
+///        buffer.write_to(std::cout);
+///
+///
+class format_buffer
+{
+public:
+    /// Constructor
+    format_buffer() : m_streambuf(m_data), m_stream(&m_streambuf)
+    {
+    }
+
+    /// Make the format_buffer non-copyable
+    format_buffer(const format_buffer&) = delete;
+    format_buffer& operator=(const format_buffer&) = delete;
+
+    /// Append a character
+    void append(char c)
+    {
+        m_data.push_back(c);
+    }
+
+    /// Append a number of characters
+    void append(const char* data, std::size_t size)
+    {
+        m_data.insert(m_data.end(), data, data + size);
+    }
+
+    /// Append a string literal
+    template <std::size_t Size>
+    void append(const char (&text)[Size])
+    {
+        append(text, Size - 1);
+    }
+
+    /// Append a value formatted as std::ostream would format it
+    template <class T>
+    void append_value(const T& value)
+    {
+        append_value(value, is_number<T>());
+    }
+
+    /// Append a floating point value with enough digits to read back the
+    /// exact value, e.g. used when exporting calls for analysis
+    template <class T>
+    void append_exact(T value)
+    {
+        static_assert(std::is_floating_point<T>::value,
+                      "Only floating point values are supported");
+        append_exact_number(value);
+    }
+
+    /// Append an unsigned integer in hexadecimal with a 0x prefix, as
+    /// std::ostream formats it using std::hex and std::showbase.
+    void append_hex(uintptr_t value)
+    {
+        // std::showbase does not add the prefix to zero
+        if (value == 0)
+        {
+            append('0');
+            return;
+        }
+
+        char digits[2 * sizeof(uintptr_t)];
+        std::size_t size = 0;
+
+        while (value != 0)
+        {
+            digits[size++] = "0123456789abcdef"[value & 0xf];
+            value >>= 4;
+        }
+
+        append("0x");
+        while (size != 0)
+        {
+            append(digits[--size]);
+        }
+    }
+
+    /// @return Stream writing into the buffer, used to format values with
+    ///         an output operator
+    std::ostream& stream()
+    {
+        return m_stream;
+    }
+
+    /// @return The formatted characters
+    const char* data() const
+    {
+        return m_data.data();
+    }
+
+    /// @return The number of formatted characters
+    std::size_t size() const
+    {
+        return m_data.size();
+    }
+
+    /// Reserve space for a number of characters
+    void reserve(std::size_t size)
+    {
+        m_data.reserve(size);
+    }
+
+    /// Remove the formatted characters, keeping the allocated memory
+    void clear()
+    {
+        m_data.clear();
+    }
+
+    /// Write the formatted characters to a stream with a single write
+    void write_to(std::ostream& out) const
+    {
+        out.write(m_data.data(), (std::streamsize)m_data.size());
+    }
+
+private:
+    /// Integers, except bool and character types which std::ostream
+    /// prints as text, and floating point values are formatted directly
+    template <class T>
+    using is_number = std::integral_constant<
+        bool,
+        (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+         !std::is_same<T, char>::value &&
+         !std::is_same<T, signed char>::value &&
+         !std::is_same<T, unsigned char>::value &&
+         !std::is_same<T, wchar_t>::value &&
+         !std::is_same<T, char16_t>::value &&
+         !std::is_same<T, char32_t>::value) ||
+            std::is_floating_point<T>::value>;
+
+    /// Format values using the output operator
+    template <class T>
+    void append_value(const T& value, std::false_type)
+    {
+        m_stream << value;
+    }
+
+    /// Format numbers directly
+    template <class T>
+    void append_value(T value, std::true_type)
+    {
+        append_number(value, std::is_integral<T>());
+    }
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    template <class T>
+    void append_number(T value, std::true_type)
+    {
+        char text[32];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        append(text, (std::size_t)(result.ptr - text));
+    }
+
+    template <class T>
+    void append_number(T value, std::false_type)
+    {
+        // The default precision of std::ostream
+        char text[64];
+        auto result = std::to_chars(text, text + sizeof(text), value,
+                                    std::chars_format::general, 6);
+        append(text, (std::size_t)(result.ptr - text));
+    }
+    template <class T>
+    void append_exact_number(T value)
+    {
+        // Without precision to_chars uses the shortest exact representation
+        char text[64];
+        auto result = std::to_chars(text, text + sizeof(text), value);
+        append(text, (std::size_t)(result.ptr - text));
+    }
+#else
+    template <class T>
+    void append_number(T value, std::true_type)
+    {
+        using unsigned_type = typename std::make_unsigned<T>::type;
+
+        // Negate as unsigned to also handle the minimum value
+        unsigned_type magnitude = (unsigned_type)value;
+        if (value < 0)
+        {
+            append('-');
+            magnitude = (unsigned_type)(0 - magnitude);
+        }
+
+        char digits[24];
+        std::size_t size = 0;
+
+        do
+        {
+            digits[size++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        while (size != 0)
+        {
+            append(digits[--size]);
+        }
+    }
+
+    void append_number(float value, std::false_type)
+    {
+        append_number((double)value, std::false_type());
+    }
+
+    void append_number(double value, std::false_type)
+    {
+        // The default precision of std::ostream
+        char text[64];
+        int size = std::snprintf(text, sizeof(text), "%g", value);
+        append(text, (std::size_t)size);
+    }
+
+    void append_number(long double value, std::false_type)
+    {
+        char text[64];
+        int size = std::snprintf(text, sizeof(text), "%Lg", value);
+        append(text, (std::size_t)size);
+    }
+
+    void append_exact_number(double value)
+    {
+        char text[64];
+        int size = std::snprintf(text, sizeof(text), "%.17g", value);
+        append(text, (std::size_t)size);
+    }
+
+    void append_exact_number(long double value)
+    {
+        char text[64];
+        int size = std::snprintf(text, sizeof(text), "%.21Lg", value);
+        append(text, (std::size_t)size);
+    }
+#endif
+
+    /// Stream buffer appending the written characters to the buffer
+    struct streambuf : public std::streambuf
+    {
+        streambuf(std::vector<char>& data) : m_data(data)
+        {
+        }
+
+        int_type overflow(int_type c) override
+        {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+            {
+                m_data.push_back(traits_type::to_char_type(c));
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char* data, std::streamsize size) override
+        {
+            m_data.insert(m_data.end(), data, data + size);
+            return size;
+        }
+
+        /// The characters of the format_buffer
+        std::vector<char>& m_data;
+    };
+
+private:
+    /// The formatted characters
+    std::vector<char> m_data;
+
+    /// Stream buffer writing into m_data
+    streambuf m_streambuf;
+
+    /// Stream used to format values with an output operator
+    std::ostream m_stream;
+};
+}
@@ -5,15 +5,27 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
+#include <memory>
 #include <ostream>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <tuple>
 
+#include "call_timing.hpp"
 #include "compare_call.hpp"
 #include "expect_calls.hpp"
+#include "format_buffer.hpp"
+#include "inline_function.hpp"
+#include "memory_budget_exceeded.hpp"
+#include "memory_usage.hpp"
 #include "print_arguments.hpp"
+#include "registry.hpp"
 #include "return_handler.hpp"
+#include "return_table.hpp"
+#include "side_effect.hpp"
 
 namespace stub
 {
@@ -22,6 +34,10 @@ namespace stub
 template <typename T>
 class function;
 
+/// The worker of the asynchronous side effects, see async_side_effects.hpp
+template <class... Args>
+class async_side_effects;
+
 ///
 /// @brief The function object act like a "sink" for function calls
 ///        i.e. we can define a function object to accept any type of
@@ -84,12 +100,44 @@ class function;
 ///        assert(b == true);
 ///
 ///
+/// Return types which cannot be copied, such as std::unique_ptr, are
+/// moved out of the function object and each value is returned once:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::function<std::unique_ptr<uint32_t>()> make;
+///        make.set_return(std::unique_ptr<uint32_t>(new uint32_t(3U)));
+///
+///        std::unique_ptr<uint32_t> value = make();
+///        assert(*value == 3U);
+///
+///
+/// The return value can also depend on the arguments of the call. Calls
+/// with arguments for which no return value has been set use the return
+/// values from set_return(...):
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::function<int(uint64_t)> lookup;
+///        lookup.set_return_for(1U, 10).set_return_for(2U, 20);
+///        lookup.set_return(-1);
+///
+///        assert(lookup(1U) == 10);
+///        assert(lookup(2U) == 20);
+///        assert(lookup(3U) == -1);
+///
+///
 /// For more information on the options for return values see the
-/// return_handler.hpp
+/// return_handler.hpp and return_table.hpp
 ///
 template <typename R, typename... Args>
-class function<R(Args...)>
+class function<R(Args...)> : private registered_stub<function<R(Args...)>>
 {
+    /// The registry reads the usage through the base class
+    friend class registered_stub<function>;
+
 public:
     /// Represent a expectation of how the function object has been
     /// invoked. Using the API it is possible to setup how we
@@ -195,6 +243,12 @@ public:
             return to_bool();
         }
 
+        /// @return The number of bytes held by the expected calls
+        std::size_t memory_usage() const
+        {
+            return m_calls.capacity() * sizeof(compare_call<Args...>);
+        }
+
     private:
         /// The function we will check the expectation against
         const function& m_function;
@@ -204,6 +258,28 @@ public:
     };
 
 public:
+    /// Constructor
+    function() = default;
+
+    /// Copy constructor
+    function(const function&) = default;
+
+    /// Move constructor
+    function(function&&) = default;
+
+    /// Copy assignment
+    function& operator=(const function&) = default;
+
+    /// Move assignment
+    function& operator=(function&&) = default;
+
+    /// Destructor, waits for the pending asynchronous side effects
+    ~function()
+    {
+        m_async.m_worker.reset();
+        this->unregister();
+    }
+
     /// The call operator to "simulate" performing a function call.
     ///
     /// @param args The arguments that should be stored
@@ -217,7 +293,31 @@ public:
         }
 
         m_calls.emplace_back(std::forward<Args>(args)...);
-        return m_return_handler();
+        const arguments<Args...>& call = m_calls.back();
+
+        if (m_timing.enabled())
+        {
+            m_timing.record(call_timing::clock::now());
+        }
+
+        if (m_memory_budget != 0)
+        {
+            check_memory_budget(call);
+        }
+
+        const uint32_t index = (uint32_t)m_calls.size() - 1;
+
+        for (auto& side_effect : m_argument_side_effects)
+        {
+            side_effect(call, index);
+        }
+
+        if (m_async.m_worker)
+        {
+            m_async.m_worker->post(call, index);
+        }
+
+        return m_return_table(call, m_return_handler);
     }
 
     /// Initializes the return_handler with the return values to
@@ -237,12 +337,193 @@ public:
             std::forward<Returns>(return_value)...);
     }
 
+    /// Set the value to return when the function is called with specific
+    /// arguments. The last argument is the return value, the other
+    /// arguments are the arguments of the call. The return values are
+    /// stored in a hash table, so std::hash must be available for the
+    /// argument types. If the function is called with other arguments
+    /// the return_handler generates the return value, i.e. the values from
+    /// set_return(...) are the default.
+    ///
+    /// @param key_and_value The arguments followed by the return value
+    ///
+    /// @return Reference to the return_table, this allows the caller to
+    /// set more return values.
+    template <class... KeyAndValue>
+    return_table<R, Args...>& set_return_for(KeyAndValue&&... key_and_value)
+    {
+        return m_return_table.set_return_for(
+            std::forward<KeyAndValue>(key_and_value)...);
+    }
+
+    /// Start a rule selecting the return value based on the arguments,
+    /// see return_table::when(...). The special values used in
+    /// expectations, e.g. ignore(), not_nullptr() and make_compare(), can
+    /// be used in rules.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        stub::function<int(uint32_t, uint32_t)> route;
+    ///        route.when(stub::ignore(), 2U).then_return(1);
+    ///        route.when(3U, stub::ignore()).then_return(2);
+    ///        route.set_return(0);
+    ///
+    ///        assert(route(1U, 2U) == 1);
+    ///        assert(route(3U, 4U) == 2);
+    ///        assert(route(4U, 4U) == 0);
+    ///
+    /// @param with The values to compare the arguments with
+    ///
+    /// @return The rule, call then_return(...) to set the return value
+    template <class... WithArgs>
+    auto when(WithArgs&&... with)
+    {
+        return m_return_table.when(std::forward<WithArgs>(with)...);
+    }
+
+    /// Initializes the return_handler to lazily return the values in the
+    /// range [first, last), see return_handler::set_return_range(...).
+    ///
+    /// @param first Iterator to the first return value
+    /// @param last Iterator one past the last return value
+    ///
+    /// @return Reference to the return handler
+    template <class Iterator>
+    return_handler<R>& set_return_range(Iterator first, Iterator last)
+    {
+        return m_return_handler.set_return_range(first, last);
+    }
+
+    /// Initializes the return_handler to lazily return count consecutive
+    /// values starting from first, see
+    /// return_handler::set_return_iota(...).
+    ///
+    /// @param first The first value to return
+    /// @param count The number of values in the sequence
+    ///
+    /// @return Reference to the return handler
+    template <class Value>
+    return_handler<R>& set_return_iota(Value first, uint32_t count)
+    {
+        return m_return_handler.set_return_iota(first, count);
+    }
+
+    /// Initializes the return_handler to return the values stored in a
+    /// memory mapped binary file, see return_handler::set_return_file(...).
+    /// Include stub/return_file.hpp to use it.
+    ///
+    /// The member is a template so it is only instantiated when used,
+    /// which allows explicit instantiation of function objects returning
+    /// void, see extern_templates.hpp.
+    ///
+    /// @param path The path of the file containing the return values
+    ///
+    /// @return Reference to the return handler
+    template <class Return = R>
+    return_handler<R>& set_return_file(const std::string& path)
+    {
+        static_assert(std::is_same<Return, R>::value,
+                      "The return type cannot be changed");
+        return m_return_handler.set_return_file(path);
+    }
+
     /// @return The number of times the call operator has been invoked
     uint32_t calls() const
     {
         return (uint32_t)m_calls.size();
     }
 
+    /// @return The number of bytes held by the function object, see
+    ///         memory_details()
+    std::size_t memory_usage() const
+    {
+        return memory_details().total();
+    }
+
+    /// The memory held by the function object divided into the call log,
+    /// the heap memory owned by the recorded arguments, the stored return
+    /// values, the side effects and the call timestamps.
+    ///
+    /// The heap memory of the arguments is found using the heap_size
+    /// trait, which can be specialized for user types. Computing it visits
+    /// every recorded call.
+    ///
+    /// @return The number of bytes held by each part
+    memory_breakdown memory_details() const
+    {
+        memory_breakdown memory;
+        memory.m_call_log = m_calls.capacity() * sizeof(arguments<Args...>);
+
+        for (const auto& call : m_calls)
+        {
+            memory.m_arguments += heap_size_of(call);
+        }
+
+        memory.m_return_values = m_return_handler.memory_usage();
+        memory.m_side_effects =
+            m_side_effects.capacity() * sizeof(inline_function<void()>) +
+            m_argument_side_effects.capacity() * sizeof(side_effect<Args...>) +
+            (m_async.m_worker ? m_async.m_worker->memory_usage() : 0);
+
+        // Callables too large for the inline buffer are on the heap
+        for (const auto& side_effect : m_side_effects)
+        {
+            memory.m_side_effects += side_effect.heap_size();
+        }
+
+        for (const auto& side_effect : m_argument_side_effects)
+        {
+            memory.m_side_effects += side_effect.heap_size();
+        }
+        memory.m_timing = m_timing.memory_usage();
+
+        return memory;
+    }
+
+    /// Set a limit on the memory held by the call log, i.e. the capacity
+    /// of the call log, the heap memory owned by the recorded arguments and
+    /// the call timestamps. If a call makes the call log exceed the budget,
+    /// the call is recorded and stub::memory_budget_exceeded is thrown
+    /// from the call operator.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        stub::function<void(std::vector<uint8_t>)> send;
+    ///        send.set_memory_budget(64 * 1024 * 1024);
+    ///
+    /// The usage is tracked incrementally so the check does not visit the
+    /// recorded calls.
+    ///
+    /// @param budget The budget in bytes, zero removes the budget
+    void set_memory_budget(std::size_t budget)
+    {
+        m_memory_budget = budget;
+        m_argument_bytes = memory_details().m_arguments;
+    }
+
+    /// @return The memory budget in bytes, zero if there is no budget
+    std::size_t memory_budget() const
+    {
+        return m_memory_budget;
+    }
+
+    /// Set the name of the function object used in the report of the
+    /// registry, see registry. The function object is registered if the
+    /// registry is enabled.
+    using registered_stub<function>::set_name;
+
+    /// @return The name of the function object in the registry
+    using registered_stub<function>::stub_name;
+
+    /// @return True if the function object is in the registry
+    using registered_stub<function>::registered;
+
     /// @return True if no calls have been made otherwise false
     bool no_calls() const
     {
@@ -270,14 +551,72 @@ public:
     /// handler.
     void clear()
     {
+        this->update_peak();
         m_return_handler = return_handler<R>();
+        m_return_table = return_table<R, Args...>();
         m_calls.clear();
+        m_timing.clear();
+        m_argument_bytes = 0;
     }
 
     /// Clear the calls
     void clear_calls()
     {
+        this->update_peak();
         m_calls.clear();
+        m_timing.clear();
+        m_argument_bytes = 0;
+    }
+
+    /// Start recording the time of each call and the gaps between calls.
+    /// Timing is disabled by default as reading the clock adds overhead to
+    /// each call. Since a timestamp is stored for each call, timing must
+    /// be enabled before the first call or after clear_calls(), otherwise
+    /// std::logic_error is thrown.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        stub::function<void(uint32_t)> my_func;
+    ///        my_func.enable_timing();
+    ///
+    ///        my_func(4U);
+    ///        my_func(5U);
+    ///
+    ///        auto gap = my_func.timing().elapsed(1);
+    ///        auto p99 = my_func.timing().gaps().value_at_percentile(99.0);
+    ///
+    /// When timing is enabled, print() includes a summary of the gaps and
+    /// the time of each call relative to the first call.
+    void enable_timing()
+    {
+        if (m_timing.enabled())
+            return;
+
+        // The calls already recorded would have no timestamps
+        if (!m_calls.empty())
+        {
+            throw std::logic_error("Enable timing before the first call");
+        }
+
+        m_timing.set_enabled(true);
+    }
+
+    /// Stop recording the time of each call. The recorded timestamps are
+    /// removed.
+    void disable_timing()
+    {
+        m_timing.set_enabled(false);
+        m_timing.clear();
+    }
+
+    /// @return The timestamps of the calls and the histogram of the gaps
+    ///         between calls, see enable_timing()
+    const call_timing& timing() const
+    {
+        return m_timing;
     }
 
     /// Prints the status of the function object to the std::ostream.
@@ -295,18 +634,117 @@ public:
     ///        // Print the current status of the function object,
     ///        std::cout << my_func << std::endl;
     ///
+    /// The calls are formatted into a format_buffer which is written to
+    /// the std::ostream in chunks, see print_calls(...).
+    ///
     /// @param out The ostream where the stub::function status should be
+    ///        written
     void print(std::ostream& out) const
     {
-        out << "Number of calls: " << m_calls.size() << std::endl;
+        print_calls(out, 0, calls());
+    }
 
-        if (sizeof...(Args) == 0)
-            return;
+    /// Prints the calls in the range [first, last) to the std::ostream,
+    /// using the same format as print(...).
+    ///
+    /// The calls are formatted into a buffer which is written to the
+    /// std::ostream whenever it holds chunk_size bytes. The memory used is
+    /// therefore bounded and the output appears incrementally, e.g. when
+    /// dumping a large function object to a file.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        std::ofstream file("my_func.txt");
+    ///
+    ///        // Print the first 1000 calls
+    ///        my_func.print_calls(file, 0, 1000);
+    ///
+    /// @param out The ostream where the calls should be written
+    /// @param first The index of the first call to print
+    /// @param last The index after the last call to print, limited to the
+    ///        number of calls
+    /// @param chunk_size The number of bytes written to the ostream at a
+    ///        time
+    void print_calls(std::ostream& out, uint32_t first, uint32_t last,
+                     std::size_t chunk_size = 65536) const
+    {
+        print_calls(out, first, last,
+                    [](uint32_t, const arguments<Args...>&) { return true; },
+                    chunk_size);
+    }
+
+    /// Prints the calls in the range [first, last) selected by a filter to
+    /// the std::ostream, see print_calls(std::ostream&, uint32_t, uint32_t,
+    /// std::size_t).
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        // Print the calls where the first argument is zero
+    ///        my_func.print_calls(std::cout, 0, my_func.calls(),
+    ///            [](uint32_t index, const std::tuple<uint32_t>& call)
+    ///            { return std::get<0>(call) == 0; });
+    ///
+    /// @param out The ostream where the calls should be written
+    /// @param first The index of the first call to print
+    /// @param last The index after the last call to print, limited to the
+    ///        number of calls
+    /// @param filter Callable invoked with the index and the arguments of
+    ///        each call in the range, returning true if the call should be
+    ///        printed
+    /// @param chunk_size The number of bytes written to the ostream at a
+    ///        time
+    template <class Filter,
+              typename std::enable_if<
+                  !std::is_integral<
+                      typename std::decay<Filter>::type>::value,
+                  uint8_t>::type = 0>
+    void print_calls(std::ostream& out, uint32_t first, uint32_t last,
+                     Filter&& filter, std::size_t chunk_size = 65536) const
+    {
+        assert(chunk_size > 0);
+
+        format_buffer buffer;
+        buffer.reserve(chunk_size + 256);
+
+        print_summary(buffer);
+
+        last = std::min(last, calls());
+
+        for (uint32_t i = first; sizeof...(Args) != 0 && i < last; ++i)
+        {
+            if (!filter(i, m_calls[i]))
+                continue;
+
+            print_call(buffer, i);
+
+            if (buffer.size() >= chunk_size)
+            {
+                buffer.write_to(out);
+                buffer.clear();
+            }
+        }
+
+        buffer.write_to(out);
+        out.flush();
+    }
+
+    /// Prints the status of the function object to the format_buffer.
+    ///
+    /// @param out The format_buffer where the stub::function status
+    ///        should be written
+    void print(format_buffer& out) const
+    {
+        print_summary(out);
 
-        for (uint32_t i = 0; i < m_calls.size(); ++i)
+        for (uint32_t i = 0; sizeof...(Args) != 0 && i < calls(); ++i)
         {
-            out << "Call " << i << ":\n";
-            print_arguments(out, m_calls[i]);
+            print_call(out, i);
         }
     }
 
@@ -333,21 +771,260 @@ public:
     ///        // Side effect
     ///        // Side effect
     ///
+    /// A side effect can also receive the arguments of the call, and
+    /// optionally the index of the call. The arguments are passed as
+    /// references to the values stored in the function object, so the
+    /// side effect does not need to keep its own copy:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        stub::function<void(uint32_t)> my_func;
+    ///
+    ///        my_func.add_side_effect([](const uint32_t& value)
+    ///        {
+    ///            std::cout << "Called with " << value << std::endl;
+    ///        });
+    ///
+    ///        my_func.add_side_effect([](uint32_t index, const uint32_t& value)
+    ///        {
+    ///            std::cout << "Call " << index << ": " << value << std::endl;
+    ///        });
+    ///
+    /// Side effects without arguments are invoked before the call is
+    /// stored, side effects receiving the arguments right after.
+    ///
+    /// Side effects fitting in an inline_function are stored inline
+    /// without allocating memory, so invoking them does not touch the
+    /// heap. Larger side effects are allocated on the heap.
+    ///
+    /// @param side_effect The side effect to add
+    template <class SideEffect>
+    void add_side_effect(SideEffect&& side_effect)
+    {
+        using callable = typename std::decay<SideEffect>::type;
+
+        add_side_effect(std::forward<SideEffect>(side_effect),
+                        is_callable_with<callable, std::tuple<>>());
+    }
+
+    /// Add an asynchronous side effect to the function object. The side
+    /// effect accepts the same arguments as with add_side_effect(...), but
+    /// instead of being invoked inside the call operator, a copy of the
+    /// arguments is added to a bounded queue and the side effect is invoked
+    /// by a background worker thread. This keeps expensive side effects
+    /// from distorting the timing of the code under test.
+    ///
+    /// Use drain() to wait for the side effects to finish before checking
+    /// their results:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        stub::function<void(std::vector<uint8_t>)> send;
+    ///
+    ///        uint32_t checksum = 0;
+    ///        send.add_async_side_effect(
+    ///            [&checksum](const std::vector<uint8_t>& data)
+    ///            { checksum = compute_checksum(data); });
+    ///
+    ///        send(std::vector<uint8_t>(1000));
+    ///
+    ///        send.drain();
+    ///        assert(checksum == ...);
+    ///
+    /// The asynchronous side effects of a function object are invoked in
+    /// order on a single worker thread. The arguments must be copyable.
+    ///
+    /// The worker thread is opt-in, include stub/async_side_effects.hpp to
+    /// use add_async_side_effect(...).
+    ///
     /// @param side_effect The side effect to add
-    void add_side_effect(std::function<void()> side_effect)
+    template <class SideEffect, class Worker = async_side_effects<Args...>>
+    void add_async_side_effect(SideEffect&& side_effect)
+    {
+        if (!m_async.m_worker)
+        {
+            m_async.m_worker.reset(new Worker());
+        }
+
+        m_async.m_worker->add(make_side_effect<Args...>(
+            std::forward<SideEffect>(side_effect)));
+    }
+
+    /// Wait until all asynchronous side effects have finished. If an
+    /// asynchronous side effect threw an exception, the first exception
+    /// is rethrown.
+    void drain() const
     {
-        m_side_effects.push_back(side_effect);
+        if (m_async.m_worker)
+        {
+            m_async.m_worker->drain();
+        }
     }
 
 private:
+    /// Throw if the call log exceeds the memory budget
+    void check_memory_budget(const arguments<Args...>& call) const
+    {
+        m_argument_bytes += heap_size_of(call);
+
+        std::size_t usage = m_calls.capacity() * sizeof(arguments<Args...>) +
+                            m_argument_bytes + m_timing.memory_usage();
+
+        if (usage > m_memory_budget)
+        {
+            throw memory_budget_exceeded(usage, m_memory_budget);
+        }
+    }
+
+    /// Print the number of calls and, when timing is enabled, the gaps
+    /// between calls. Shared by print(...) and print_calls(...).
+    void print_summary(format_buffer& out) const
+    {
+        out.append("Number of calls: ");
+        out.append_value(m_calls.size());
+        out.append('\n');
+
+        if (m_timing.enabled())
+        {
+            print_gaps(out);
+        }
+    }
+
+    /// Print a single call and, when timing is enabled, its time relative
+    /// to the first call. Shared by print(...) and print_calls(...).
+    void print_call(format_buffer& out, uint32_t index) const
+    {
+        out.append("Call ");
+        out.append_value(index);
+
+        if (m_timing.enabled())
+        {
+            out.append(" at ");
+            out.append_value(m_timing.elapsed(index).count());
+            out.append(" ns");
+        }
+
+        out.append(":\n");
+        print_arguments(out, m_calls[index]);
+    }
+
+    /// Print a summary of the gaps between calls
+    void print_gaps(format_buffer& out) const
+    {
+        const gap_histogram& gaps = m_timing.gaps();
+
+        out.append("Call gaps: min ");
+        out.append_value(gaps.min());
+        out.append(" ns, mean ");
+        out.append_value(gaps.mean());
+        out.append(" ns, p50 ");
+        out.append_value(gaps.value_at_percentile(50.0));
+        out.append(" ns, p99 ");
+        out.append_value(gaps.value_at_percentile(99.0));
+        out.append(" ns, max ");
+        out.append_value(gaps.max());
+        out.append(" ns\n");
+    }
+
+    /// Add a side effect without arguments
+    template <class SideEffect>
+    void add_side_effect(SideEffect&& side_effect, std::true_type)
+    {
+        m_side_effects.emplace_back(std::forward<SideEffect>(side_effect));
+    }
+
+    /// Add a side effect receiving the arguments
+    template <class SideEffect>
+    void add_side_effect(SideEffect&& side_effect, std::false_type)
+    {
+        m_argument_side_effects.push_back(make_side_effect<Args...>(
+            std::forward<SideEffect>(side_effect)));
+    }
+
+    /// Holder of the worker invoking the asynchronous side effects. The
+    /// worker owns the side effects, and copies of the function object get
+    /// a worker of their own. Copying, moving or assigning a function
+    /// object first waits for the pending side effects of the source, so
+    /// they have finished when drain() returns on either function object.
+    struct async_holder
+    {
+        async_holder() = default;
+
+        async_holder(const async_holder& other) :
+            m_worker(other.m_worker ? other.m_worker->clone() : nullptr)
+        {
+        }
+
+        async_holder(async_holder&& other)
+        {
+            other.wait();
+            m_worker = std::move(other.m_worker);
+        }
+
+        async_holder& operator=(const async_holder& other)
+        {
+            if (this != &other)
+            {
+                m_worker = other.m_worker ? other.m_worker->clone() : nullptr;
+            }
+            return *this;
+        }
+
+        async_holder& operator=(async_holder&& other)
+        {
+            if (this != &other)
+            {
+                other.wait();
+                m_worker = std::move(other.m_worker);
+            }
+            return *this;
+        }
+
+        /// Wait for the pending side effects, exceptions thrown by the side
+        /// effects are kept for the next drain()
+        void wait() const
+        {
+            if (m_worker)
+            {
+                m_worker->wait();
+            }
+        }
+
+        /// The worker, created when the first asynchronous side effect is
+        /// added
+        std::unique_ptr<async_side_effects_interface<Args...>> m_worker;
+    };
+
+private:
+    /// The worker invoking the asynchronous side effects
+    async_holder m_async;
+
     /// The return_handler manages the return values generated
     return_handler<R> m_return_handler;
 
+    /// The return_table manages the return values for specific arguments
+    return_table<R, Args...> m_return_table;
+
     /// Stores the arguments every time the operator() is invoked
     mutable std::vector<arguments<Args...>> m_calls;
 
     /// Side effects
-    std::vector<std::function<void()>> m_side_effects;
+    std::vector<inline_function<void()>> m_side_effects;
+
+    /// Side effects receiving the arguments of the call
+    std::vector<side_effect<Args...>> m_argument_side_effects;
+
+    /// The time of each call, when timing is enabled
+    mutable call_timing m_timing;
+
+    /// The memory budget of the call log in bytes, zero if not set
+    std::size_t m_memory_budget = 0;
+
+    /// The heap memory owned by the recorded arguments, tracked when a
+    /// memory budget is set
+    mutable std::size_t m_argument_bytes = 0;
 };
 
 /// Output operator for printing function objects, see more info in
@@ -368,3 +1045,9 @@ inline std::ostream& operator<<(std::ostream& out, const function<T>& function)
 }
 
 } // namespace stub
+
+// Use the instantiations of the common signatures compiled in the
+// stub_instantiations library
+#if defined(STUB_EXTERN_TEMPLATES)
+#include "extern_templates.hpp"
+#endif
@@ -0,0 +1,73 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace stub
+{
+/// Trait telling whether std::hash is available for a type. Types without
+/// a std::hash specialization get a disabled std::hash which cannot be
+/// constructed.
+template <class T>
+struct is_hashable : std::is_default_constructible<std::hash<T>>
+{
+};
+
+/// Hash function for the tuples storing the arguments of a call. The
+/// elements are hashed using std::hash and the hashes combined, so
+/// std::hash must be available for every argument type.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::hash_arguments<std::tuple<uint32_t, bool>> hash;
+///
+///        std::size_t h = hash(std::make_tuple(4U, true));
+///
+///
+template <class Tuple>
+struct hash_arguments;
+
+/// Specialization for tuples
+template <class... T>
+struct hash_arguments<std::tuple<T...>>
+{
+    /// @return The hash of the tuple
+    std::size_t operator()(const std::tuple<T...>& t) const
+    {
+        return hash(t, std::index_sequence_for<T...>());
+    }
+
+private:
+    template <std::size_t... Index>
+    static std::size_t hash(const std::tuple<T...>& t,
+                            std::index_sequence<Index...>)
+    {
+        (void)t;
+        std::size_t seed = 0;
+
+        // The elements of a braced list are evaluated in order
+        std::initializer_list<int>{(combine(seed, std::get<Index>(t)), 0)...};
+
+        return seed;
+    }
+
+    template <class Value>
+    static void combine(std::size_t& seed, const Value& value)
+    {
+        seed ^= std::hash<Value>()(value) + 0x9e3779b9 + (seed << 6) +
+                (seed >> 2);
+    }
+};
+}
@@ -0,0 +1,294 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace stub
+{
+/// Default inline_function
+template <class Signature, std::size_t Capacity = 64>
+class inline_function;
+
+/// @brief Callable wrapper similar to std::function which stores the
+///        callable inline in a fixed size buffer, so wrapping a callable
+///        never allocates memory.
+///
+/// Callables larger than the capacity, or requiring a larger alignment
+/// than the buffer, are allocated on the heap and a pointer to them is
+/// stored in the buffer instead. The default capacity is large enough to
+/// hold a std::function or lambdas capturing a handful of values or
+/// references.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        uint32_t count = 0;
+///        stub::inline_function<void()> f = [&count]() { ++count; };
+///
+///        f();
+///        assert(count == 1U);
+///
+///
+template <class R, class... Args, std::size_t Capacity>
+class inline_function<R(Args...), Capacity>
+{
+    static_assert(Capacity >= sizeof(void*),
+                  "The capacity must be large enough to hold a pointer");
+
+public:
+    /// Construct an empty inline_function
+    inline_function() : m_invoke(nullptr), m_manage(nullptr)
+    {
+    }
+
+    /// Construct an inline_function storing the callable
+    ///
+    /// @param callable The callable to store
+    template <class Callable,
+              class Decayed = typename std::decay<Callable>::type,
+              typename std::enable_if<
+                  !std::is_same<Decayed, inline_function>::value,
+                  uint8_t>::type = 0>
+    inline_function(Callable&& callable) :
+        m_invoke(&invoke<Decayed>), m_manage(&placement<Decayed>::manage)
+    {
+        placement<Decayed>::create(&m_storage,
+                                   std::forward<Callable>(callable));
+    }
+
+    /// @return True if the callable is stored in the inline buffer, false
+    ///         if it is allocated on the heap
+    template <class Callable>
+    static constexpr bool stored_inline()
+    {
+        return sizeof(Callable) <= Capacity &&
+               alignof(Callable) <= alignof(storage);
+    }
+
+    /// Copy constructor
+    inline_function(const inline_function& other) :
+        m_invoke(other.m_invoke), m_manage(other.m_manage)
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(operation::copy, &m_storage, &other.m_storage);
+        }
+    }
+
+    /// Move constructor
+    inline_function(inline_function&& other) :
+        m_invoke(other.m_invoke), m_manage(other.m_manage)
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(operation::move, &m_storage, &other.m_storage);
+        }
+    }
+
+    /// Copy assignment
+    inline_function& operator=(const inline_function& other)
+    {
+        if (this != &other)
+        {
+            inline_function copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    /// Move assignment
+    inline_function& operator=(inline_function&& other)
+    {
+        if (this != &other)
+        {
+            reset();
+
+            m_invoke = other.m_invoke;
+            m_manage = other.m_manage;
+
+            if (m_manage != nullptr)
+            {
+                m_manage(operation::move, &m_storage, &other.m_storage);
+            }
+        }
+        return *this;
+    }
+
+    /// Destructor
+    ~inline_function()
+    {
+        reset();
+    }
+
+    /// Invoke the stored callable
+    ///
+    /// @param args The arguments passed to the callable
+    ///
+    /// @return The value returned by the callable
+    R operator()(Args... args) const
+    {
+        assert(m_invoke != nullptr);
+        return m_invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+    /// @return True if a callable is stored otherwise false
+    explicit operator bool() const
+    {
+        return m_invoke != nullptr;
+    }
+
+    /// @return The number of bytes allocated on the heap for the stored
+    ///         callable, zero if it is stored inline or no callable is
+    ///         stored
+    std::size_t heap_size() const
+    {
+        if (m_manage == nullptr)
+            return 0;
+
+        return m_manage(operation::heap_size, nullptr, nullptr);
+    }
+
+private:
+    /// The operations needed to manage the lifetime of the callable and
+    /// report its heap memory
+    enum class operation
+    {
+        copy,
+        move,
+        destroy,
+        heap_size
+    };
+
+    /// The buffer storing the callable
+    using storage = typename std::aligned_storage<Capacity>::type;
+
+    /// Callable stored in the buffer
+    template <class Callable>
+    struct local
+    {
+        template <class Value>
+        static void create(void* data, Value&& value)
+        {
+            new (data) Callable(std::forward<Value>(value));
+        }
+
+        static Callable& get(void* data)
+        {
+            return *static_cast<Callable*>(data);
+        }
+
+        /// Copy, move or destroy the callable stored in the buffer
+        ///
+        /// @return The heap size for operation::heap_size, otherwise zero
+        static std::size_t manage(operation op, void* data, const void* other)
+        {
+            switch (op)
+            {
+            case operation::copy:
+                new (data) Callable(*static_cast<const Callable*>(other));
+                break;
+            case operation::move:
+                new (data) Callable(std::move(
+                    *static_cast<Callable*>(const_cast<void*>(other))));
+                break;
+            case operation::destroy:
+                static_cast<Callable*>(data)->~Callable();
+                break;
+            case operation::heap_size:
+                break;
+            }
+            return 0;
+        }
+    };
+
+    /// Callable allocated on the heap with a pointer stored in the buffer
+    template <class Callable>
+    struct remote
+    {
+        template <class Value>
+        static void create(void* data, Value&& value)
+        {
+            *static_cast<Callable**>(data) =
+                new Callable(std::forward<Value>(value));
+        }
+
+        static Callable& get(void* data)
+        {
+            return **static_cast<Callable**>(data);
+        }
+
+        /// Copy, move or destroy the callable pointed to by the buffer
+        ///
+        /// @return The heap size for operation::heap_size, otherwise zero
+        static std::size_t manage(operation op, void* data, const void* other)
+        {
+            switch (op)
+            {
+            case operation::copy:
+                *static_cast<Callable**>(data) =
+                    new Callable(**static_cast<Callable* const*>(other));
+                break;
+            case operation::move:
+                // Moving only transfers the pointer
+                *static_cast<Callable**>(data) =
+                    *static_cast<Callable* const*>(other);
+                *static_cast<Callable**>(const_cast<void*>(other)) = nullptr;
+                break;
+            case operation::destroy:
+                delete *static_cast<Callable**>(data);
+                break;
+            case operation::heap_size:
+                return sizeof(Callable);
+            }
+            return 0;
+        }
+    };
+
+    /// The placement of a callable, inline if it fits in the buffer
+    template <class Callable>
+    using placement =
+        typename std::conditional<stored_inline<Callable>(), local<Callable>,
+                                  remote<Callable>>::type;
+
+    /// Invoke the stored callable
+    template <class Callable>
+    static R invoke(void* data, Args&&... args)
+    {
+        return placement<Callable>::get(data)(std::forward<Args>(args)...);
+    }
+
+    /// Destroy the stored callable
+    void reset()
+    {
+        if (m_manage != nullptr)
+        {
+            m_manage(operation::destroy, &m_storage, nullptr);
+        }
+
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+private:
+    /// Function invoking the stored callable
+    R (*m_invoke)(void*, Args&&...);
+
+    /// Function managing the lifetime of the stored callable
+    std::size_t (*m_manage)(operation, void*, const void*);
+
+    /// The buffer storing the callable. The buffer is mutable since
+    /// callables are allowed to modify their state when invoked.
+    mutable storage m_storage;
+};
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace stub
+{
+/// @brief Trait telling whether a copy of a value can be instantiated.
+///
+/// Unlike std::is_copy_constructible the trait also checks the elements of
+/// containers, since e.g. std::vector<std::unique_ptr<T>> declares a copy
+/// constructor which fails to compile when used.
+template <class T, class = void>
+struct is_copyable : std::is_copy_constructible<T>
+{
+};
+
+/// Specialization for containers, i.e. types with a value_type and an
+/// iterator, which are only copyable if their elements are
+template <class T>
+struct is_copyable<T, decltype(void(std::declval<typename T::value_type*>()),
+                               void(std::declval<typename T::iterator*>()))>
+    : std::integral_constant<
+          bool, std::is_copy_constructible<T>::value &&
+                    is_copyable<typename std::remove_cv<
+                        typename T::value_type>::type>::value>
+{
+};
+}
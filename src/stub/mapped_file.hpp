@@ -0,0 +1,210 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace stub
+{
+/// Read-only memory mapping of a file. The content of the file is loaded
+/// on demand by the operating system when the data is accessed, so
+/// opening even a very large file has a constant cost.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::mapped_file file("responses.bin");
+///
+///        const uint8_t* data = file.data();
+///        std::size_t size = file.size();
+///
+/// A std::system_error is thrown if the file cannot be mapped.
+class mapped_file
+{
+public:
+    /// Map the file at the given path
+    ///
+    /// @param path The path of the file to map
+    mapped_file(const std::string& path) : m_data(nullptr), m_size(0)
+    {
+        map(path);
+    }
+
+    /// Unmap the file
+    ~mapped_file()
+    {
+        unmap();
+    }
+
+    /// Make the mapped_file non-copyable
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    /// @return Pointer to the content of the file, nullptr if the file is
+    ///         empty
+    const uint8_t* data() const
+    {
+        return m_data;
+    }
+
+    /// @return The size of the file in bytes
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+#if defined(_WIN32)
+    void map(const std::string& path)
+    {
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                                  nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+            throw_error(GetLastError(), "Could not open " + path);
+
+        // The error is read before closing the handle, which may overwrite
+        // it
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            DWORD error = GetLastError();
+            CloseHandle(file);
+            throw_error(error, "Could not get the size of " + path);
+        }
+
+        // The size must fit in the address space, e.g. of a 32 bit process
+        if ((uint64_t)size.QuadPart > (uint64_t)SIZE_MAX)
+        {
+            CloseHandle(file);
+            throw_error(ERROR_FILE_TOO_LARGE, "Could not map " + path);
+        }
+
+        m_size = (std::size_t)size.QuadPart;
+
+        if (m_size == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        // The size is passed as two 32 bit halves
+        HANDLE mapping = CreateFileMappingA(
+            file, nullptr, PAGE_READONLY, (DWORD)((uint64_t)m_size >> 32),
+            (DWORD)((uint64_t)m_size & 0xffffffffU), nullptr);
+        DWORD error = GetLastError();
+        CloseHandle(file);
+
+        if (mapping == nullptr)
+            throw_error(error, "Could not map " + path);
+
+        m_data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0,
+                                               m_size);
+        error = GetLastError();
+        CloseHandle(mapping);
+
+        if (m_data == nullptr)
+            throw_error(error, "Could not map " + path);
+    }
+
+    void unmap()
+    {
+        if (m_data != nullptr)
+            UnmapViewOfFile(m_data);
+    }
+
+    [[noreturn]] static void throw_error(DWORD error,
+                                         const std::string& message)
+    {
+        throw std::system_error((int)error, std::system_category(), message);
+    }
+#else
+    void map(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd == -1)
+            throw_error("Could not open " + path);
+
+        struct stat info;
+        if (::fstat(fd, &info) == -1)
+        {
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            throw_error("Could not get the size of " + path);
+        }
+
+        // The size must fit in the address space, e.g. of a 32 bit process
+        if ((uint64_t)info.st_size > (uint64_t)SIZE_MAX)
+        {
+            ::close(fd);
+            errno = EFBIG;
+            throw_error("Could not map " + path);
+        }
+
+        m_size = (std::size_t)info.st_size;
+
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return;
+        }
+
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            errno = error;
+            throw_error("Could not map " + path);
+        }
+
+        m_data = (const uint8_t*)data;
+    }
+
+    void unmap()
+    {
+        if (m_data != nullptr)
+            ::munmap((void*)m_data, m_size);
+    }
+
+    [[noreturn]] static void throw_error(const std::string& message)
+    {
+        throw std::system_error(errno, std::generic_category(), message);
+    }
+#endif
+
+private:
+    /// Pointer to the mapped content of the file
+    const uint8_t* m_data;
+
+    /// The size of the file in bytes
+    std::size_t m_size;
+};
+}
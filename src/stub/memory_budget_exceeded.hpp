@@ -0,0 +1,36 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace stub
+{
+/// Exception thrown when the call log of a function object grows beyond
+/// its memory budget, see function::set_memory_budget(...).
+struct memory_budget_exceeded : public std::runtime_error
+{
+    /// Constructor
+    ///
+    /// @param usage The number of bytes held by the call log
+    /// @param budget The memory budget in bytes
+    memory_budget_exceeded(std::size_t usage, std::size_t budget) :
+        std::runtime_error("The call log holds " + std::to_string(usage) +
+                           " bytes which exceeds the memory budget of " +
+                           std::to_string(budget) + " bytes"),
+        m_usage(usage), m_budget(budget)
+    {
+    }
+
+    /// The number of bytes held by the call log
+    std::size_t m_usage;
+
+    /// The memory budget in bytes
+    std::size_t m_budget;
+};
+}
@@ -0,0 +1,190 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stub
+{
+/// @brief Trait returning the number of heap bytes owned by a value, i.e.
+///        memory not included in sizeof(T).
+///
+/// The default is zero. Specializations are provided for std::string,
+/// std::vector, std::unique_ptr, std::pair and std::tuple. The trait can
+/// be specialized for user types:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        namespace stub
+///        {
+///        template <>
+///        struct heap_size<my_packet>
+///        {
+///            static std::size_t get(const my_packet& packet)
+///            {
+///                return packet.payload_capacity();
+///            }
+///        };
+///        }
+///
+template <class T, class Enable = void>
+struct heap_size
+{
+    /// @return The number of heap bytes owned by the value
+    static std::size_t get(const T&)
+    {
+        return 0;
+    }
+};
+
+/// @return The number of heap bytes owned by the value, see heap_size
+template <class T>
+inline std::size_t heap_size_of(const T& value)
+{
+    return heap_size<T>::get(value);
+}
+
+/// Specialization for strings, zero if the characters are stored inside
+/// the string object (the small string optimization)
+template <class Char, class Traits, class Allocator>
+struct heap_size<std::basic_string<Char, Traits, Allocator>>
+{
+    using string_type = std::basic_string<Char, Traits, Allocator>;
+
+    static std::size_t get(const string_type& value)
+    {
+        const char* object = (const char*)&value;
+        const char* data = (const char*)value.data();
+
+        // std::less gives a total order over unrelated pointers, which the
+        // built-in comparisons do not
+        std::less<const char*> less;
+        if (!less(data, object) && less(data, object + sizeof(string_type)))
+            return 0;
+
+        return (value.capacity() + 1) * sizeof(Char);
+    }
+};
+
+/// Specialization for vectors, the capacity and the heap bytes of the
+/// elements
+template <class T, class Allocator>
+struct heap_size<std::vector<T, Allocator>>
+{
+    static std::size_t get(const std::vector<T, Allocator>& value)
+    {
+        return value.capacity() * sizeof(T) +
+               elements(value, std::is_trivially_copyable<T>());
+    }
+
+    /// Trivially copyable elements do not own heap memory
+    static std::size_t elements(const std::vector<T, Allocator>&,
+                                std::true_type)
+    {
+        return 0;
+    }
+
+    static std::size_t elements(const std::vector<T, Allocator>& value,
+                                std::false_type)
+    {
+        std::size_t size = 0;
+        for (const auto& element : value)
+        {
+            size += heap_size_of(element);
+        }
+        return size;
+    }
+};
+
+/// Specialization for std::vector<bool> which stores a bit per element
+template <class Allocator>
+struct heap_size<std::vector<bool, Allocator>>
+{
+    static std::size_t get(const std::vector<bool, Allocator>& value)
+    {
+        return (value.capacity() + 7) / 8;
+    }
+};
+
+/// Specialization for unique pointers, the pointed-to object and its heap
+/// bytes
+template <class T, class Deleter>
+struct heap_size<std::unique_ptr<T, Deleter>,
+                 typename std::enable_if<!std::is_array<T>::value>::type>
+{
+    static std::size_t get(const std::unique_ptr<T, Deleter>& value)
+    {
+        return value ? sizeof(T) + heap_size_of(*value) : 0;
+    }
+};
+
+/// Specialization for pairs
+template <class First, class Second>
+struct heap_size<std::pair<First, Second>>
+{
+    static std::size_t get(const std::pair<First, Second>& value)
+    {
+        return heap_size_of(value.first) + heap_size_of(value.second);
+    }
+};
+
+/// Specialization for tuples, e.g. the arguments of a call
+template <class... T>
+struct heap_size<std::tuple<T...>>
+{
+    static std::size_t get(const std::tuple<T...>& value)
+    {
+        return get(value, std::index_sequence_for<T...>());
+    }
+
+    template <std::size_t... Index>
+    static std::size_t get(const std::tuple<T...>& value,
+                           std::index_sequence<Index...>)
+    {
+        (void)value;
+
+        std::size_t size = 0;
+        std::initializer_list<int>{
+            (size += heap_size_of(std::get<Index>(value)), 0)...};
+        return size;
+    }
+};
+
+/// The memory held by a function object, see function::memory_details()
+struct memory_breakdown
+{
+    /// The capacity of the call log
+    std::size_t m_call_log = 0;
+
+    /// The heap memory owned by the recorded arguments, see heap_size
+    std::size_t m_arguments = 0;
+
+    /// The stored return values, see return_handler::memory_usage()
+    std::size_t m_return_values = 0;
+
+    /// The storage of the side effects
+    std::size_t m_side_effects = 0;
+
+    /// The call timestamps, see function::enable_timing()
+    std::size_t m_timing = 0;
+
+    /// @return The total number of bytes
+    std::size_t total() const
+    {
+        return m_call_log + m_arguments + m_return_values + m_side_effects +
+               m_timing;
+    }
+};
+}
@@ -7,16 +7,24 @@
 
 #include <cstdint>
 #include <iomanip>
+#include <ios>
 #include <ostream>
 
+#include "format_buffer.hpp"
+#include "print_value.hpp"
+
 namespace stub
 {
-/// Default printer - just use the std::ostream operator<< to output
-/// the values to the stream.
+/// Default printer - use print_value(...) to output the values to the
+/// stream. Values are written using the std::ostream operator<< except
+/// byte buffers, long strings and ranges which are printed in a bounded
+/// form, see print_value(...).
 template <class T>
-inline void print_argument(std::ostream& out, uint32_t index, T value)
+inline void print_argument(std::ostream& out, uint32_t index, const T& value)
 {
-    out << "Arg " << index << ": " << value << "\n";
+    out << "Arg " << index << ": ";
+    print_value(out, value);
+    out << "\n";
 }
 
 /// Overload of the default printer function for pointer types.
@@ -39,7 +47,38 @@ inline void print_argument(std::ostream& out, uint32_t index, T* value)
     // to work a bit more to print the value of the pointer as hex but
     // using the code below we get the same string representation on
     // all tested platforms.
+    //
+    // The flags of the stream are restored so the following arguments are
+    // not printed as hex.
+    const std::ios_base::fmtflags flags = out.flags();
+
     out << "Arg " << std::dec << std::noshowbase << index << ": " << std::hex
         << std::showbase << (uintptr_t)value << "\n";
+
+    out.flags(flags);
+}
+
+/// Printer writing to a format_buffer, produces the same text as the
+/// std::ostream printer. Numbers are formatted directly into the buffer.
+template <class T>
+inline void print_argument(format_buffer& out, uint32_t index, const T& value)
+{
+    out.append("Arg ");
+    out.append_value(index);
+    out.append(": ");
+    print_value(out, value);
+    out.append('\n');
+}
+
+/// Overload of the format_buffer printer for pointer types, see the
+/// std::ostream overload for pointer types above.
+template <class T>
+inline void print_argument(format_buffer& out, uint32_t index, T* value)
+{
+    out.append("Arg ");
+    out.append_value(index);
+    out.append(": ");
+    out.append_hex((uintptr_t)value);
+    out.append('\n');
 }
 }
@@ -7,53 +7,37 @@
 
 #include "print_argument.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <tuple>
-#include <type_traits>
+#include <utility>
 
 namespace stub
 {
-/// Specialization chosen for empty tuples or when Index reaches the
-/// sizeof the tuple (i.e. the number of values in the tuple), see
-/// description below.
-template <class Index = std::integral_constant<uint32_t, 0U>, class... Args,
-          class LastIndex = std::integral_constant<uint32_t, sizeof...(Args)>,
-          typename std::enable_if<std::is_same<Index, LastIndex>::value,
-                                  uint8_t>::type = 0>
-inline void print_arguments(std::ostream& out, const std::tuple<Args...>& t)
+/// Print the values at the given indices of a tuple in order
+template <class Output, class... Args, std::size_t... Index>
+inline void print_arguments(Output& out, const std::tuple<Args...>& t,
+                            std::index_sequence<Index...>)
 {
     (void)out;
     (void)t;
+
+    // The elements of a braced list are evaluated in order
+    std::initializer_list<int>{
+        (print_argument(out, (uint32_t)Index, std::get<Index>(t)), 0)...};
 }
 
-/// Prints the content of a tuple to the specified std::ostream.
-///
-/// The two functions print_arguments use SFINAE (Substitution Failure
-/// Is Not An Error) to select which overload to call.
-///
-/// The overloading works like this:
+/// Prints the content of a tuple to the specified std::ostream or
+/// format_buffer, calling print_argument(...) with the index and the
+/// value of each element.
 ///
-///   1. If print_arguments is called with an empty tuple then the
-///      empty overload will be chosen.
-///
-///   2. If print_argument is called with a non-empty tuple the
-///      Index!=LastIndex is true and the overload writing to the
-///      std::ostream will be called. This will then recursively call
-///      print_arguments incrementing the Index. A some point
-///      Index==LastIndex and the empty overload gets chosen and we
-///      are done.
-///
-/// Note that initially this was implemented using a simpler technique
-/// similar to here: http://stackoverflow.com/a/6894436 but this did
-/// not work on with Microsoft Visual Studio 2013 so it was implemented
-/// using the std::integral_constant technique instead.
-template <class Index = std::integral_constant<uint32_t, 0U>, class... Args,
-          class LastIndex = std::integral_constant<uint32_t, sizeof...(Args)>,
-          typename std::enable_if<!std::is_same<Index, LastIndex>::value,
-                                  uint8_t>::type = 0>
-inline void print_arguments(std::ostream& out, const std::tuple<Args...>& t)
+/// The values are visited by expanding an index sequence rather than by
+/// recursion, so the number of instantiations does not grow with the
+/// number of arguments.
+template <class Output, class... Args>
+inline void print_arguments(Output& out, const std::tuple<Args...>& t)
 {
-    print_argument(out, Index::value, std::get<Index::value>(t));
-
-    print_arguments<std::integral_constant<uint32_t, Index::value + 1>>(out, t);
+    print_arguments(out, t, std::index_sequence_for<Args...>());
 }
 }
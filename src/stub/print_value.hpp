@@ -0,0 +1,303 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+#include "format_buffer.hpp"
+
+namespace stub
+{
+/// Strings up to this size are printed as text
+static const std::size_t print_text_limit = 64;
+
+/// Byte buffers up to twice this size are printed in full, larger buffers
+/// are printed as the first and last print_preview_bytes bytes
+static const std::size_t print_preview_bytes = 16;
+
+/// Ranges up to twice this size are printed in full, larger ranges are
+/// printed as the first and last print_preview_values values
+static const std::size_t print_preview_values = 8;
+
+/// Trait telling whether a value can be written to a std::ostream
+template <class T, class = void>
+struct is_streamable : std::false_type
+{
+};
+
+/// Specialization chosen when operator<< is available
+template <class T>
+struct is_streamable<T, decltype(void(std::declval<std::ostream&>()
+                                      << std::declval<const T&>()))>
+    : std::true_type
+{
+};
+
+/// Trait telling whether a value is a contiguous buffer of bytes or
+/// characters, i.e. has data() and size() and one byte integral elements
+template <class T, class = void>
+struct is_byte_buffer : std::false_type
+{
+};
+
+/// Specialization chosen when data() and size() are available
+template <class T>
+struct is_byte_buffer<T, decltype(void(std::declval<const T&>().size()),
+                                  void(*std::declval<const T&>().data()))>
+    : std::integral_constant<
+          bool, sizeof(*std::declval<const T&>().data()) == 1 &&
+                    std::is_integral<typename std::remove_cv<
+                        typename std::remove_reference<decltype(
+                            *std::declval<const T&>().data())>::type>::type>::
+                        value>
+{
+};
+
+/// Trait telling whether a value is a range, i.e. can be iterated using
+/// std::begin() and std::end()
+template <class T, class = void>
+struct is_range : std::false_type
+{
+};
+
+/// Specialization chosen when std::begin() and std::end() are available
+template <class T>
+struct is_range<T, decltype(void(std::begin(std::declval<const T&>())),
+                            void(std::end(std::declval<const T&>())))>
+    : std::true_type
+{
+};
+
+/// 32 bit FNV-1a checksum of a number of bytes
+inline uint32_t print_checksum(const uint8_t* data, std::size_t size)
+{
+    uint32_t hash = 2166136261U;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+/// Write a number of characters to a std::ostream
+inline void print_text(std::ostream& out, const char* data, std::size_t size)
+{
+    out.write(data, (std::streamsize)size);
+}
+
+/// Write a number of characters to a format_buffer
+inline void print_text(format_buffer& out, const char* data, std::size_t size)
+{
+    out.append(data, size);
+}
+
+/// Write a value using operator<< to a std::ostream
+template <class T>
+inline void print_streamed(std::ostream& out, const T& value)
+{
+    out << value;
+}
+
+/// Write a value to a format_buffer, numbers are formatted directly
+template <class T>
+inline void print_streamed(format_buffer& out, const T& value)
+{
+    out.append_value(value);
+}
+
+/// Write an unsigned integer in decimal
+template <class Output>
+inline void print_size(Output& out, std::size_t size)
+{
+    char digits[24];
+    std::size_t count = 0;
+
+    do
+    {
+        digits[sizeof(digits) - ++count] = (char)('0' + size % 10);
+        size /= 10;
+    } while (size != 0);
+
+    print_text(out, digits + sizeof(digits) - count, count);
+}
+
+/// Write a number of bytes in hex
+template <class Output>
+inline void print_hex(Output& out, const uint8_t* data, std::size_t size)
+{
+    char text[2 * print_preview_bytes];
+
+    while (size != 0)
+    {
+        std::size_t count = std::min(size, print_preview_bytes);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            text[2 * i] = "0123456789abcdef"[data[i] >> 4];
+            text[2 * i + 1] = "0123456789abcdef"[data[i] & 0xf];
+        }
+
+        print_text(out, text, 2 * count);
+        data += count;
+        size -= count;
+    }
+}
+
+/// Print a byte buffer as its size, a hex preview of the bytes and a
+/// checksum of all bytes, e.g. "3 bytes: 0102ff (fnv1a 0x12345678)".
+/// Buffers larger than twice print_preview_bytes are printed as the first
+/// and last bytes, e.g. "4096 bytes: 0001...feff (fnv1a 0x12345678)".
+///
+/// @param out The std::ostream or format_buffer where the text is written
+/// @param data Pointer to the bytes
+/// @param size The number of bytes
+template <class Output>
+inline void print_bytes(Output& out, const uint8_t* data, std::size_t size)
+{
+    print_size(out, size);
+    print_text(out, " bytes: ", 8);
+
+    if (size <= 2 * print_preview_bytes)
+    {
+        print_hex(out, data, size);
+    }
+    else
+    {
+        print_hex(out, data, print_preview_bytes);
+        print_text(out, "...", 3);
+        print_hex(out, data + size - print_preview_bytes,
+                  print_preview_bytes);
+    }
+
+    uint32_t checksum = print_checksum(data, size);
+    uint8_t bytes[4] = {(uint8_t)(checksum >> 24), (uint8_t)(checksum >> 16),
+                        (uint8_t)(checksum >> 8), (uint8_t)checksum};
+
+    print_text(out, " (fnv1a 0x", 10);
+    print_hex(out, bytes, sizeof(bytes));
+    print_text(out, ")", 1);
+}
+
+/// Print a value, see the definition below
+template <class Output, class T>
+inline void print_value(Output& out, const T& value);
+
+/// Tags used to select how a value is printed
+struct print_as_streamed
+{
+};
+struct print_as_text
+{
+};
+struct print_as_bytes
+{
+};
+struct print_as_range
+{
+};
+
+/// Select how a value is printed. Byte buffers which can be written to a
+/// std::ostream, e.g. std::string, are printed as text unless they are
+/// large. Other byte buffers are printed using print_bytes(...). Ranges
+/// without operator<<, e.g. std::vector<uint32_t>, are printed as a
+/// number of values.
+template <class T>
+using print_category = typename std::conditional<
+    is_byte_buffer<T>::value,
+    typename std::conditional<is_streamable<T>::value, print_as_text,
+                              print_as_bytes>::type,
+    typename std::conditional<is_range<T>::value && !is_streamable<T>::value,
+                              print_as_range,
+                              print_as_streamed>::type>::type;
+
+/// Print a value using its category, see print_value(...)
+template <class Output, class T>
+inline void print_value(Output& out, const T& value, print_as_streamed)
+{
+    print_streamed(out, value);
+}
+
+/// Print a byte buffer which can be written to a std::ostream
+template <class Output, class T>
+inline void print_value(Output& out, const T& value, print_as_text)
+{
+    if (value.size() <= print_text_limit)
+    {
+        print_streamed(out, value);
+    }
+    else
+    {
+        print_bytes(out, (const uint8_t*)value.data(), value.size());
+    }
+}
+
+/// Print a byte buffer
+template <class Output, class T>
+inline void print_value(Output& out, const T& value, print_as_bytes)
+{
+    print_bytes(out, (const uint8_t*)value.data(), value.size());
+}
+
+/// Print a range
+template <class Output, class T>
+inline void print_value(Output& out, const T& value, print_as_range)
+{
+    auto first = std::begin(value);
+    auto last = std::end(value);
+
+    std::size_t size = (std::size_t)std::distance(first, last);
+
+    print_size(out, size);
+    print_text(out, " values: {", 10);
+
+    // Skip the values in the middle of large ranges
+    std::size_t index = 0;
+    for (auto it = first; it != last; ++it, ++index)
+    {
+        if (index == print_preview_values && size > 2 * print_preview_values)
+        {
+            print_text(out, ", ...", 5);
+            std::advance(it, size - 2 * print_preview_values);
+            index = size - print_preview_values;
+        }
+
+        if (index != 0)
+            print_text(out, ", ", 2);
+
+        print_value(out, *it);
+    }
+
+    print_text(out, "}", 1);
+}
+
+/// Print a value, selecting how it is printed by its type:
+///
+///   - Byte buffers, i.e. with data() and size() and one byte elements
+///     such as std::vector<uint8_t>, are printed as their size, a hex
+///     preview of the first and last bytes and a checksum.
+///   - Strings longer than print_text_limit characters are printed as
+///     byte buffers, shorter strings are printed as text.
+///   - Ranges without operator<<, e.g. std::vector<uint32_t>, are printed
+///     as their size and the first and last values, e.g.
+///     "100 values: {0, 1, ..., 98, 99}".
+///   - Other values are printed using operator<<.
+///
+/// The size of the printed text is therefore bounded regardless of the
+/// size of the value.
+///
+/// @param out The std::ostream or format_buffer where the text is written
+/// @param value The value to print
+template <class Output, class T>
+inline void print_value(Output& out, const T& value)
+{
+    print_value(out, value, print_category<T>());
+}
+}
@@ -0,0 +1,450 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stub
+{
+/// The usage of a stub registered in the registry, see registry::stats()
+struct registry_stats
+{
+    /// The name of the stub, empty if the stub is not named
+    std::string m_name;
+
+    /// The number of calls currently recorded
+    uint64_t m_calls = 0;
+
+    /// The number of bytes currently held, see function::memory_usage()
+    std::size_t m_bytes = 0;
+
+    /// The largest number of calls observed. The usage is sampled, not
+    /// tracked on every call: it is read by stats() and report(), before
+    /// the calls are removed by function::clear() and
+    /// function::clear_calls(), before the function object is assigned to
+    /// and when it is destroyed. Since the calls only grow between these
+    /// points the peak number of calls is exact.
+    uint64_t m_peak_calls = 0;
+
+    /// The largest number of bytes observed at the sampling points, see
+    /// m_peak_calls. A larger usage held only between two sampling points,
+    /// e.g. return values replaced by function::set_return(...), is missed.
+    std::size_t m_peak_bytes = 0;
+
+    /// The number of destroyed stubs with this name summed up in the
+    /// stats, zero for a live stub. The calls are the calls recorded when
+    /// the stubs were destroyed, the peaks the largest of the stubs and the
+    /// bytes are zero.
+    uint64_t m_destroyed = 0;
+};
+
+/// @brief Opt-in registry of the live function objects, used to find the
+///        stubs which are called the most or hold the most memory, e.g. in
+///        a large test fixture.
+///
+/// The registry is disabled by default. Once enabled, every function object
+/// constructed registers itself and is removed again when destroyed.
+/// Function objects can be given a name used in the report with
+/// function::set_name(...). The usage of destroyed function objects is
+/// kept per name, so a report at the end of a test also includes the stubs
+/// which are no longer alive.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::registry::instance().enable();
+///
+///        stub::function<void(uint32_t)> send;
+///        send.set_name("send");
+///
+///        // ... run the test
+///
+///        stub::registry::instance().report(std::cout);
+///
+/// The registry is thread-safe, but the usage of a stub is read without
+/// synchronization, so stats() and report() should not be called while
+/// the stubs are invoked from other threads.
+class registry
+{
+public:
+    /// Function filling in the current usage of a registered stub
+    using query_function = void (*)(const void* owner, registry_stats& stats);
+
+    /// @return The registry shared by all function objects
+    static registry& instance()
+    {
+        // The registry is never destroyed, so function objects with static
+        // storage duration can unregister safely
+        static registry* the_registry = new registry();
+        return *the_registry;
+    }
+
+    /// Make the registry non-copyable
+    registry(const registry&) = delete;
+    registry& operator=(const registry&) = delete;
+
+    /// Register the function objects constructed from now on
+    void enable()
+    {
+        m_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    /// Stop registering new function objects. Function objects already
+    /// registered stay registered until they are destroyed.
+    void disable()
+    {
+        m_enabled.store(false, std::memory_order_relaxed);
+    }
+
+    /// @return True if new function objects are registered
+    bool enabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Add a stub to the registry
+    ///
+    /// @param owner The address identifying the stub
+    /// @param query Function returning the usage of the stub
+    /// @param name The name of the stub
+    void add(const void* owner, query_function query, const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        entry& added = m_entries[owner];
+        added.m_query = query;
+        added.m_stats = registry_stats();
+        added.m_stats.m_name = name;
+    }
+
+    /// Remove a stub from the registry. The usage of the stub is added to
+    /// the destroyed stubs with the same name.
+    ///
+    /// @param owner The address identifying the stub
+    /// @param read True if the final usage can be read from the stub,
+    ///        otherwise the usage last read is used, e.g. when the members
+    ///        of the stub are already destroyed
+    void remove(const void* owner, bool read = true)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(owner);
+        if (it == m_entries.end())
+            return;
+
+        if (read)
+            update(owner, it->second);
+
+        const registry_stats& stats = it->second.m_stats;
+        registry_stats& destroyed = m_destroyed[stats.m_name];
+
+        destroyed.m_name = stats.m_name;
+        destroyed.m_calls += stats.m_calls;
+        destroyed.m_peak_calls =
+            std::max(destroyed.m_peak_calls, stats.m_peak_calls);
+        destroyed.m_peak_bytes =
+            std::max(destroyed.m_peak_bytes, stats.m_peak_bytes);
+        ++destroyed.m_destroyed;
+
+        m_entries.erase(it);
+    }
+
+    /// Forget the usage of the destroyed stubs, e.g. between tests
+    void clear_destroyed()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_destroyed.clear();
+    }
+
+    /// @return True if the stub is registered
+    bool contains(const void* owner) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.count(owner) != 0;
+    }
+
+    /// Set the name of a registered stub
+    void set_name(const void* owner, const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(owner);
+        if (it != m_entries.end())
+            it->second.m_stats.m_name = name;
+    }
+
+    /// @return The name of a registered stub, empty if not registered
+    std::string name(const void* owner) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(owner);
+        return it == m_entries.end() ? std::string()
+                                     : it->second.m_stats.m_name;
+    }
+
+    /// Update the peak usage of a stub, called before its calls are
+    /// removed so the peak is not lost
+    void update_peak(const void* owner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_entries.find(owner);
+        if (it != m_entries.end())
+            update(owner, it->second);
+    }
+
+    /// @return The number of registered stubs
+    std::size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    /// @return The usage of the registered stubs followed by the destroyed
+    ///         stubs per name, sorted by cost, i.e. by the largest number
+    ///         of bytes held and then by the number of calls
+    std::vector<registry_stats> stats()
+    {
+        std::vector<registry_stats> result;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            result.reserve(m_entries.size() + m_destroyed.size());
+
+            for (auto& owner_and_entry : m_entries)
+            {
+                update(owner_and_entry.first, owner_and_entry.second);
+                result.push_back(owner_and_entry.second.m_stats);
+            }
+
+            for (const auto& name_and_stats : m_destroyed)
+            {
+                result.push_back(name_and_stats.second);
+            }
+        }
+
+        std::sort(result.begin(), result.end(),
+                  [](const registry_stats& a, const registry_stats& b)
+                  {
+                      if (a.m_peak_bytes != b.m_peak_bytes)
+                          return a.m_peak_bytes > b.m_peak_bytes;
+                      if (a.m_calls != b.m_calls)
+                          return a.m_calls > b.m_calls;
+                      return a.m_name < b.m_name;
+                  });
+
+        return result;
+    }
+
+    /// Print the usage of the registered stubs sorted by cost, e.g.:
+    ///
+    /// .. code-block:: text
+    ///
+    ///        Registered stubs: 2, destroyed: 3, calls: 1400, bytes: 17408
+    ///        send: 1000 calls (peak 1000), 16384 bytes (peak 16384)
+    ///        receive (3 destroyed): 300 calls (peak 100), 0 bytes (peak 8192)
+    ///        <unnamed>: 100 calls (peak 250), 1024 bytes (peak 4096)
+    ///
+    /// @param out The std::ostream where the report is written
+    /// @param limit The largest number of stubs to print
+    void report(std::ostream& out, std::size_t limit = SIZE_MAX)
+    {
+        std::vector<registry_stats> all = stats();
+
+        uint64_t live = 0;
+        uint64_t destroyed = 0;
+        uint64_t calls = 0;
+        std::size_t bytes = 0;
+        for (const auto& stub : all)
+        {
+            live += stub.m_destroyed == 0 ? 1 : 0;
+            destroyed += stub.m_destroyed;
+            calls += stub.m_calls;
+            bytes += stub.m_bytes;
+        }
+
+        out << "Registered stubs: " << live << ", destroyed: " << destroyed
+            << ", calls: " << calls << ", bytes: " << bytes << "\n";
+
+        for (std::size_t i = 0; i < all.size() && i < limit; ++i)
+        {
+            const registry_stats& stub = all[i];
+
+            out << (stub.m_name.empty() ? "<unnamed>" : stub.m_name);
+
+            if (stub.m_destroyed != 0)
+                out << " (" << stub.m_destroyed << " destroyed)";
+
+            out << ": " << stub.m_calls << " calls (peak " << stub.m_peak_calls
+                << "), " << stub.m_bytes << " bytes (peak "
+                << stub.m_peak_bytes << ")\n";
+        }
+    }
+
+private:
+    /// Constructor, use instance()
+    registry() : m_enabled(false)
+    {
+    }
+
+    /// A registered stub
+    struct entry
+    {
+        /// Function returning the usage of the stub
+        query_function m_query = nullptr;
+
+        /// The last usage read from the stub
+        registry_stats m_stats;
+    };
+
+    /// Read the current usage of a stub and update the peaks
+    static void update(const void* owner, entry& stub)
+    {
+        registry_stats& stats = stub.m_stats;
+        stub.m_query(owner, stats);
+
+        stats.m_peak_calls = std::max(stats.m_peak_calls, stats.m_calls);
+        stats.m_peak_bytes = std::max(stats.m_peak_bytes, stats.m_bytes);
+    }
+
+private:
+    /// True if new function objects are registered
+    std::atomic<bool> m_enabled;
+
+    /// Protects the entries
+    mutable std::mutex m_mutex;
+
+    /// The registered stubs
+    std::unordered_map<const void*, entry> m_entries;
+
+    /// The usage of the destroyed stubs per name
+    std::map<std::string, registry_stats> m_destroyed;
+};
+
+/// @brief Base class registering a function object in the registry, see
+///        registry.
+///
+/// The registration follows the object rather than its contents: copies
+/// and moved-to objects are registered as new stubs with the same name,
+/// and assignment keeps the registration of the assigned-to object.
+///
+/// Stub is the class deriving from registered_stub. It must make
+/// registered_stub a friend, provide calls() and memory_usage() and call
+/// unregister() in its destructor.
+template <class Stub>
+class registered_stub
+{
+public:
+    /// Constructor
+    registered_stub() : m_registered(false)
+    {
+        if (registry::instance().enabled())
+            add(std::string());
+    }
+
+    /// Copy constructor
+    registered_stub(const registered_stub& other) : m_registered(false)
+    {
+        if (registry::instance().enabled() || other.m_registered)
+            add(other.stub_name());
+    }
+
+    /// Copy assignment, keeps the current registration. The base is
+    /// assigned before the members of Stub, so the peak usage is recorded
+    /// before the calls are replaced.
+    registered_stub& operator=(const registered_stub&)
+    {
+        update_peak();
+        return *this;
+    }
+
+    /// Destructor. The usage last read is kept if the stub was not
+    /// unregistered by Stub, see unregister().
+    ~registered_stub()
+    {
+        if (m_registered)
+            registry::instance().remove(this, false);
+    }
+
+    /// Set the name used in the registry report. The stub is registered if
+    /// the registry is enabled.
+    ///
+    /// @param name The name of the stub
+    void set_name(const std::string& name)
+    {
+        if (m_registered)
+            registry::instance().set_name(this, name);
+        else if (registry::instance().enabled())
+            add(name);
+    }
+
+    /// @return The name used in the registry report, empty if the stub is
+    ///         not registered or not named
+    std::string stub_name() const
+    {
+        return m_registered ? registry::instance().name(this) : std::string();
+    }
+
+    /// @return True if the stub is registered
+    bool registered() const
+    {
+        return m_registered;
+    }
+
+protected:
+    /// Record the peak usage of the stub before its calls are removed
+    void update_peak() const
+    {
+        if (m_registered)
+            registry::instance().update_peak(this);
+    }
+
+    /// Remove the stub from the registry keeping its final usage. Called
+    /// from the destructor of Stub while its members are still alive.
+    void unregister()
+    {
+        if (m_registered)
+        {
+            registry::instance().remove(this);
+            m_registered = false;
+        }
+    }
+
+private:
+    /// Add the stub to the registry
+    void add(const std::string& name)
+    {
+        registry::instance().add(this, &query, name);
+        m_registered = true;
+    }
+
+    /// Read the usage of the stub, called by the registry
+    static void query(const void* owner, registry_stats& stats)
+    {
+        auto stub = static_cast<const Stub*>(
+            static_cast<const registered_stub*>(owner));
+
+        stats.m_calls = stub->calls();
+        stats.m_bytes = stub->memory_usage();
+    }
+
+private:
+    /// True if the stub is registered
+    bool m_registered;
+};
+}
@@ -0,0 +1,222 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "arguments.hpp"
+#include "call_timing.hpp"
+#include "function.hpp"
+#include "trace.hpp"
+
+namespace stub
+{
+/// Options controlling how calls are replayed, see replay(...)
+struct replay_options
+{
+    /// The number of times the calls are replayed
+    uint32_t m_iterations = 1;
+
+    /// Measure the latency of each call. Reading the clock around each
+    /// call adds overhead, so turn it off to only measure throughput.
+    bool m_measure_latency = true;
+};
+
+/// The result of replaying calls, see replay(...). The latencies are zero
+/// if they were not measured. The latencies are recorded in a
+/// gap_histogram, so the percentiles have a relative error of at most
+/// 1/16, while the shortest, longest and mean latencies are exact.
+struct replay_result
+{
+    /// The number of calls made
+    uint64_t m_calls = 0;
+
+    /// The total time spent replaying the calls
+    std::chrono::nanoseconds m_duration{0};
+
+    /// The shortest latency of a call
+    std::chrono::nanoseconds m_min_latency{0};
+
+    /// The mean latency of the calls
+    std::chrono::nanoseconds m_mean_latency{0};
+
+    /// The median latency of the calls
+    std::chrono::nanoseconds m_median_latency{0};
+
+    /// The 99th percentile latency of the calls
+    std::chrono::nanoseconds m_p99_latency{0};
+
+    /// The longest latency of a call
+    std::chrono::nanoseconds m_max_latency{0};
+
+    /// @return The number of calls per second
+    double calls_per_second() const
+    {
+        if (m_duration.count() == 0)
+            return 0.0;
+
+        return (double)m_calls * 1e9 / (double)m_duration.count();
+    }
+};
+
+/// Invoke the callable with the arguments of a call
+template <class Callable, class Call, std::size_t... Index>
+inline void replay_call(Callable& callable, const Call& call,
+                        std::index_sequence<Index...>)
+{
+    (void)call;
+    callable(std::get<Index>(call)...);
+}
+
+/// Replay a number of calls, where get_call(i) returns the arguments of
+/// the i'th call, see replay(...)
+template <class GetCall, class Callable>
+inline replay_result replay_calls(std::size_t count, GetCall&& get_call,
+                                  Callable& callable,
+                                  const replay_options& options)
+{
+    using clock = std::chrono::steady_clock;
+    using call_type = typename std::decay<decltype(get_call(0))>::type;
+    using index = std::make_index_sequence<std::tuple_size<call_type>::value>;
+
+    assert(options.m_iterations > 0);
+
+    replay_result result;
+    result.m_calls = (uint64_t)count * options.m_iterations;
+
+    // The histogram has a fixed size, independent of the number of calls
+    gap_histogram latencies;
+
+    auto start = clock::now();
+
+    for (uint32_t i = 0; i < options.m_iterations; ++i)
+    {
+        for (std::size_t j = 0; j < count; ++j)
+        {
+            if (!options.m_measure_latency)
+            {
+                replay_call(callable, get_call(j), index());
+                continue;
+            }
+
+            auto before = clock::now();
+            replay_call(callable, get_call(j), index());
+            auto after = clock::now();
+
+            latencies.record((uint64_t)std::chrono::duration_cast<
+                                 std::chrono::nanoseconds>(after - before)
+                                 .count());
+        }
+    }
+
+    result.m_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock::now() - start);
+
+    using std::chrono::nanoseconds;
+
+    result.m_min_latency = nanoseconds(latencies.min());
+    result.m_mean_latency = nanoseconds(latencies.mean());
+    result.m_median_latency = nanoseconds(latencies.value_at_percentile(50.0));
+    result.m_p99_latency = nanoseconds(latencies.value_at_percentile(99.0));
+    result.m_max_latency = nanoseconds(latencies.max());
+
+    return result;
+}
+
+/// Replay recorded calls by invoking a callable with the same arguments in
+/// the same order, e.g. to benchmark a real implementation using the calls
+/// captured by a stub.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::function<void(uint32_t, const std::vector<uint8_t>&)> send;
+///
+///        // ... record the calls made by the code under test
+///
+///        real_socket socket;
+///        auto result = stub::replay(send,
+///            [&](uint32_t id, const std::vector<uint8_t>& data)
+///            { socket.send(id, data); });
+///
+///        std::cout << result.calls_per_second() << std::endl;
+///
+/// The arguments are passed to the callable as const references.
+///
+/// @param calls The arguments of the recorded calls
+/// @param callable The callable to invoke
+/// @param options Options controlling the replay
+///
+/// @return The number of calls made, the time spent and the latencies
+template <class Call, class Callable>
+inline replay_result replay(const std::vector<Call>& calls,
+                            Callable&& callable,
+                            const replay_options& options = replay_options())
+{
+    return replay_calls(
+        calls.size(),
+        [&calls](std::size_t i) -> const Call& { return calls[i]; }, callable,
+        options);
+}
+
+/// Replay the calls recorded by a function object, see
+/// replay(const std::vector<Call>&, Callable&&, const replay_options&).
+///
+/// @param function The function object whose calls are replayed
+/// @param callable The callable to invoke
+/// @param options Options controlling the replay
+///
+/// @return The number of calls made, the time spent and the latencies
+template <class R, class... Args, class Callable>
+inline replay_result replay(const function<R(Args...)>& function,
+                            Callable&& callable,
+                            const replay_options& options = replay_options())
+{
+    return replay_calls(
+        function.calls(),
+        [&function](std::size_t i) -> const arguments<Args...>&
+        { return function.call_arguments((uint32_t)i); },
+        callable, options);
+}
+
+/// Replay the calls stored in a binary trace written by write_trace(...).
+/// The calls are loaded before the replay starts so reading the trace is
+/// not included in the measurements.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        std::ifstream file("send.trace", std::ios::binary);
+///
+///        auto result = stub::replay_trace<uint32_t, std::vector<uint8_t>>(
+///            file, [&](uint32_t id, const std::vector<uint8_t>& data)
+///            { socket.send(id, data); });
+///
+/// @param in The stream from where the trace is read
+/// @param callable The callable to invoke
+/// @param options Options controlling the replay
+///
+/// @return The number of calls made, the time spent and the latencies
+template <class... Args, class Callable>
+inline replay_result replay_trace(std::istream& in, Callable&& callable,
+                                  const replay_options& options =
+                                      replay_options())
+{
+    return replay(read_trace<Args...>(in), std::forward<Callable>(callable),
+                  options);
+}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <stdexcept>
+
+namespace stub
+{
+
+/// Exception thrown when a return_handler has no more return values, i.e.
+/// all values have been returned and repeat has been turned off with
+/// no_repeat(), or no return values were set.
+///
+/// The exception derives from std::out_of_range, which was thrown by
+/// earlier versions of the return_handler.
+struct return_exhausted : public std::out_of_range
+{
+    /// Constructor
+    return_exhausted() :
+        std::out_of_range("No more return values, all values have been "
+                          "returned and repeat is turned off")
+    {
+    }
+};
+
+}
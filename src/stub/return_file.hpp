@@ -0,0 +1,86 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "mapped_file.hpp"
+#include "return_handler.hpp"
+
+namespace stub
+{
+/// @brief Return values stored in a memory mapped binary file, used by
+///        return_handler::set_return_file(...).
+///
+/// The header is opt-in since the memory mapping pulls in the system
+/// headers of the platform, include it to use set_return_file(...):
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        #include <stub/return_file.hpp>
+///
+///        stub::return_handler<uint32_t> v;
+///        v.set_return_file("responses.bin").no_repeat();
+///
+/// The file must contain a sequence of trivially copyable values stored
+/// back to back in the native byte order.
+template <class T>
+class return_file
+{
+public:
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "File return values must be trivially copyable");
+
+    /// Map the file at the given path
+    ///
+    /// A std::system_error is thrown if the file cannot be mapped and a
+    /// std::runtime_error if the size of the file is not a multiple of the
+    /// size of the values or the file holds more than 2^32 - 1 values.
+    ///
+    /// @param path The path of the file containing the values
+    return_file(const std::string& path) : m_file(path)
+    {
+        if (m_file.size() % sizeof(T) != 0)
+        {
+            throw std::runtime_error(
+                "The size of " + path +
+                " is not a multiple of the size of the return type");
+        }
+
+        if (m_file.size() / sizeof(T) > UINT32_MAX)
+        {
+            throw std::runtime_error("The file " + path +
+                                     " contains too many return values");
+        }
+    }
+
+    /// @return The number of values in the file
+    uint32_t size() const
+    {
+        return (uint32_t)(m_file.size() / sizeof(T));
+    }
+
+    /// @return The value at the given position
+    T get(uint32_t position) const
+    {
+        // The mapping is not guaranteed to be aligned for the type so we
+        // copy the bytes into the value
+        T value;
+        std::memcpy(&value, m_file.data() + (std::size_t)position * sizeof(T),
+                    sizeof(T));
+        return value;
+    }
+
+private:
+    /// The memory mapped file
+    mapped_file m_file;
+};
+}
@@ -5,14 +5,32 @@
 
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
-#include <deque>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "is_copyable.hpp"
+#include "memory_usage.hpp"
+#include "return_exhausted.hpp"
 #include "unqualified_type.hpp"
 
 namespace stub
 {
+/// Return values stored in a memory mapped file, see return_file.hpp
+template <class T>
+class return_file;
+
 /// @brief The return_handler is a helper object that is used
 ///        e.g. in the function object to control which return values
 ///        should be generated when called.
@@ -87,7 +105,7 @@ namespace stub
 ///        v.set_return(1U).no_repeat();
 ///
 ///        uint32_t a = v();
-///        uint32_t b = v(); // <---- Crash
+///        uint32_t b = v(); // <---- Throws stub::return_exhausted
 ///
 ///        return_handler<uint32_t> v;
 ///        v.set_return({1U,2U,3U}).no_repeat();
@@ -95,7 +113,47 @@ namespace stub
 ///        uint32_t a = v();
 ///        uint32_t b = v();
 ///        uint32_t c = v();
-///        uint32_t d = v(); // <---- Crash
+///        uint32_t d = v(); // <---- Throws stub::return_exhausted
+///
+/// Calling move_out() will move each return value out of the
+/// return_handler instead of copying it. Every value can therefore only be
+/// returned once, which avoids copying large return values:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        return_handler<std::vector<uint8_t>> v;
+///        v.set_return(std::vector<uint8_t>(1000000)).move_out();
+///
+///        std::vector<uint8_t> a = v(); // <---- No copy
+///        std::vector<uint8_t> b = v(); // <---- Throws stub::return_exhausted
+///
+/// Return types which cannot be copied, e.g. std::unique_ptr, are always
+/// moved out:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        return_handler<std::unique_ptr<uint32_t>> v;
+///        v.set_return(std::unique_ptr<uint32_t>(new uint32_t(4U)));
+///
+///        std::unique_ptr<uint32_t> a = v();
+///        assert(*a == 4U);
+///
+/// The return_handler is not thread-safe by default. When invoked
+/// concurrently from multiple threads a thread-safe cursor can be selected
+/// with either atomic_cursor(), where the threads share the sequence of
+/// return values, or per_thread_cursor(), where each thread sees the full
+/// sequence of return values:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        return_handler<uint32_t> v;
+///        v.set_return(1U, 2U, 3U).no_repeat().atomic_cursor();
+///
+///        // Each value is returned exactly once across all threads, and
+///        // stub::return_exhausted is thrown once all values are used.
 ///
 ///
 template <class R>
@@ -106,7 +164,9 @@ public:
     using return_type = typename unqualified_type<R>::type;
 
     /// Constructor
-    return_handler() : m_repeat(true), m_position(0)
+    return_handler() :
+        m_repeat(true), m_move_out(false), m_position(0),
+        m_cursor(cursor::single), m_size(0)
     {
     }
 
@@ -120,6 +180,9 @@ public:
     /// return_handler state. So any previously specified returns
     /// values will be removed etc.
     ///
+    /// If the return type cannot be copied the values are moved out and
+    /// can only be returned once, see move_out().
+    ///
     /// @param values The list of return values to use
     ///
     /// @return Reference to the return handler, this allows the
@@ -128,78 +191,576 @@ public:
     template <class... Args>
     return_handler& set_return(Args&&... values)
     {
-        m_repeat = true;
-        m_position = 0;
-        m_returns.clear();
+        reset();
+        m_repeat = is_copyable<return_type>::value;
+        m_returns.reserve(sizeof...(Args));
+
+        // Expand the values in order without recursing per value
+        std::initializer_list<int>{
+            (add_return(std::forward<Args>(values)), 0)...};
+        m_size = (uint32_t)m_returns.size();
+
+        return *this;
+    }
+
+    /// Initializes the return_handler to return the values in the range
+    /// [first, last). The values are not copied up front, instead the
+    /// iterator is stepped forward on each invocation of the call operator.
+    /// The range must therefore stay valid while the return_handler is
+    /// used.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        std::vector<uint32_t> values = {1U, 2U, 3U};
+    ///
+    ///        return_handler<uint32_t> v;
+    ///        v.set_return_range(values.begin(), values.end());
+    ///
+    ///        assert(v() == 1U && v() == 2U && v() == 3U && v() == 1U);
+    ///
+    /// @param first Iterator to the first return value
+    /// @param last Iterator one past the last return value
+    ///
+    /// @return Reference to the return handler
+    template <class Iterator>
+    return_handler& set_return_range(Iterator first, Iterator last)
+    {
+        static_assert(!std::is_reference<R>::value,
+                      "Lazy return values must be returned by value");
 
-        add_return(std::forward<Args>(values)...);
+        reset();
+        m_source = std::make_shared<range_source<Iterator>>(first, last);
+        m_size = m_source->size();
+
+        return *this;
+    }
+
+    /// Initializes the return_handler to return count consecutive values
+    /// starting from first, i.e. first, first + 1, ..., first + count - 1.
+    /// The values are computed on each invocation of the call operator.
+    ///
+    /// Example:
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        return_handler<uint32_t> v;
+    ///        v.set_return_iota(0U, 10000000U).no_repeat();
+    ///
+    ///        assert(v() == 0U && v() == 1U && v() == 2U);
+    ///
+    /// @param first The first value to return
+    /// @param count The number of values in the sequence
+    ///
+    /// @return Reference to the return handler
+    return_handler& set_return_iota(return_type first, uint32_t count)
+    {
+        static_assert(!std::is_reference<R>::value,
+                      "Lazy return values must be returned by value");
+
+        reset();
+        m_source = std::make_shared<iota_source>(first, count);
+        m_size = m_source->size();
+
+        return *this;
+    }
+
+    /// Initializes the return_handler to return the values stored in a
+    /// binary file. The file must contain a sequence of trivially copyable
+    /// return values stored back to back in the native byte order. The
+    /// file is memory mapped so the values are loaded on demand when
+    /// returned.
+    ///
+    /// The memory mapping is opt-in, include stub/return_file.hpp to use
+    /// set_return_file(...):
+    ///
+    /// .. code-block:: c++
+    ///    :linenos:
+    ///
+    ///        #include <stub/return_file.hpp>
+    ///
+    ///        return_handler<uint32_t> v;
+    ///        v.set_return_file("responses.bin").no_repeat();
+    ///
+    /// A std::system_error is thrown if the file cannot be mapped and a
+    /// std::runtime_error if the size of the file is not a multiple of the
+    /// size of the return type.
+    ///
+    /// @param path The path of the file containing the return values
+    ///
+    /// @return Reference to the return handler
+    template <class File = return_file<return_type>>
+    return_handler& set_return_file(const std::string& path)
+    {
+        static_assert(!std::is_reference<R>::value,
+                      "Lazy return values must be returned by value");
+
+        auto file = std::make_shared<file_source<File>>(path);
+
+        reset();
+        m_source = file;
+        m_size = m_source->size();
 
         return *this;
     }
 
     /// Set repeat off. This means that no values will be repeated
     /// the user has to specify exactly the number of values that
-    /// should be return otherwise an assert will be triggered.
+    /// should be return otherwise stub::return_exhausted is thrown.
     /// @todo consider making opposite behavior default.
-    void no_repeat()
+    ///
+    /// @return Reference to the return handler
+    return_handler& no_repeat()
     {
         m_repeat = false;
+        return *this;
+    }
+
+    /// Move the return values out of the return_handler instead of
+    /// copying them. This implies no_repeat() since a value can only be
+    /// moved out once.
+    ///
+    /// @return Reference to the return handler
+    return_handler& move_out()
+    {
+        m_repeat = false;
+        m_move_out = true;
+        return *this;
+    }
+
+    /// Use an atomic cursor to select the next return value. This makes it
+    /// safe to invoke the return_handler concurrently from multiple
+    /// threads without locking. The threads share the sequence of return
+    /// values, i.e. every value is returned once per repetition.
+    ///
+    /// As with the default cursor, stub::return_exhausted is thrown if all
+    /// values have been returned and repeat is turned off.
+    ///
+    /// Note, return values from set_return_range(...) must use random
+    /// access iterators to be thread-safe.
+    ///
+    /// @return Reference to the return handler
+    return_handler& atomic_cursor()
+    {
+        m_cursor = cursor::atomic;
+        m_atomic_position.store(m_position);
+        return *this;
+    }
+
+    /// Use a separate cursor for every thread invoking the return_handler.
+    /// Every thread will see the full sequence of return values, as if it
+    /// was the only thread invoking the return_handler.
+    ///
+    /// As with the default cursor, stub::return_exhausted is thrown if all
+    /// values have been returned to a thread and repeat is turned off.
+    ///
+    /// The positions of the threads are stored in the return_handler and
+    /// protected by a mutex, so copies of the return_handler have their
+    /// own positions.
+    ///
+    /// Note, the values cannot be moved out when every thread returns
+    /// them, and return values from set_return_range(...) must use random
+    /// access iterators to be thread-safe.
+    ///
+    /// @return Reference to the return handler
+    return_handler& per_thread_cursor()
+    {
+        assert(!m_move_out && is_copyable<return_type>::value);
+
+        m_cursor = cursor::per_thread;
+        m_thread_positions.clear();
+        return *this;
     }
 
     /// The call operator which will generate a return value.
+    ///
+    /// The return values are stored contiguously and the position wraps
+    /// around to the beginning when repeating, i.e. the values are used as
+    /// a ring buffer. Invoking the return_handler without a return value
+    /// throws stub::return_exhausted.
+    ///
     /// @return The generated return value
     R operator()() const
     {
-        // Did you forget to add a return value?
-        assert(m_returns.size() > 0);
+        uint32_t position;
+
+        if (m_cursor == cursor::single)
+        {
+            // Did you forget to add a return value? Or did you call the
+            // return_handler more times than values specified with
+            // no_repeat()?
+            position = m_position;
+            if (position >= m_size)
+            {
+                throw return_exhausted();
+            }
 
-        // If we are repeating and we have reached the end of the
-        // list of return values
-        if (m_repeat && (m_position == m_returns.size()))
-            m_position = 0;
+            const uint32_t next = position + 1;
 
-        assert(m_position < m_returns.size());
+            // Wrap around only when repeating, otherwise we move past the
+            // end and the check above will catch the next invocation.
+            m_position = (m_repeat && next == m_size) ? 0 : next;
+        }
+        else
+        {
+            position = concurrent_position();
+        }
 
-        R value = m_returns.at(m_position);
-        ++m_position;
+        if (m_source)
+        {
+            return m_source->get(position);
+        }
 
-        return value;
+        return get(position, is_copyable<return_type>());
+    }
+
+    /// @return The number of bytes held by the stored return values,
+    ///         including the heap memory owned by the values, see
+    ///         heap_size. Lazily generated return values are not included.
+    std::size_t memory_usage() const
+    {
+        std::size_t size = m_returns.capacity() * sizeof(slot);
+
+        if (!std::is_trivially_copyable<return_type>::value)
+        {
+            for (const auto& value : m_returns)
+            {
+                size += heap_size_of(value.m_value);
+            }
+        }
+
+        return size;
     }
 
 private:
-    /// Overload that adds a return value
-    void add_return(const return_type& value)
+    /// The cursors used to select the next return value
+    enum class cursor
+    {
+        /// Single threaded cursor
+        single,
+
+        /// Cursor shared between threads
+        atomic,
+
+        /// Cursor for every thread
+        per_thread
+    };
+
+    /// @return The position of the next return value when using one of
+    ///         the thread-safe cursors
+    uint32_t concurrent_position() const
     {
-        m_returns.push_back(value);
+        uint64_t ticket;
+
+        if (m_cursor == cursor::atomic)
+        {
+            ticket = m_atomic_position.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            ticket = m_thread_positions.next(m_repeat, m_size);
+        }
+
+        if (ticket < m_size)
+        {
+            return (uint32_t)ticket;
+        }
+
+        if (!m_repeat || m_size == 0)
+        {
+            throw return_exhausted();
+        }
+
+        return (uint32_t)(ticket % m_size);
     }
 
-    /// Add a number of return values
-    template <class... Args>
-    void add_return(const return_type& value, Args&&... more)
+    /// Reset the state and remove all return values
+    void reset()
     {
-        m_returns.push_back(value);
-        add_return(std::forward<Args>(more)...);
+        m_repeat = true;
+        m_move_out = false;
+        m_cursor = cursor::single;
+        m_position = 0;
+        m_atomic_position.store(0);
+        m_thread_positions.clear();
+        m_size = 0;
+        m_returns.clear();
+        m_source.reset();
     }
 
+    /// Get the value at position for types that can be copied
+    R get(uint32_t position, std::true_type) const
+    {
+        if (m_move_out)
+        {
+            return std::move(m_returns[position].m_value);
+        }
+
+        return m_returns[position].m_value;
+    }
+
+    /// Get the value at position for types that can only be moved
+    R get(uint32_t position, std::false_type) const
+    {
+        return std::move(m_returns[position].m_value);
+    }
+
+    /// Add a return value
+    void add_return(return_type value)
+    {
+        m_returns.push_back(slot{std::move(value)});
+    }
+
+private:
+    /// Interface used in the type erasure of lazily generated return
+    /// values
+    struct source
+    {
+        virtual ~source()
+        {
+        }
+
+        /// @return The number of values in the source
+        virtual uint32_t size() const = 0;
+
+        /// @return The value at the given position
+        virtual R get(uint32_t position) = 0;
+    };
+
+    /// Source returning the values of an iterator range
+    template <class Iterator>
+    struct range_source : public source
+    {
+        range_source(Iterator first, Iterator last) :
+            m_first(first), m_current(first), m_current_position(0),
+            m_size((uint32_t)std::distance(first, last))
+        {
+        }
+
+        uint32_t size() const override
+        {
+            return m_size;
+        }
+
+        R get(uint32_t position) override
+        {
+            using category =
+                typename std::iterator_traits<Iterator>::iterator_category;
+
+            return get(position,
+                       std::is_base_of<std::random_access_iterator_tag,
+                                       category>());
+        }
+
+        /// Random access iterators are indexed directly, which does not
+        /// modify the source and is therefore thread-safe
+        R get(uint32_t position, std::true_type) const
+        {
+            return m_first[position];
+        }
+
+        /// Other iterators are stepped forward from the last position
+        R get(uint32_t position, std::false_type)
+        {
+            // Start over when wrapping around
+            if (position < m_current_position)
+            {
+                m_current = m_first;
+                m_current_position = 0;
+            }
+
+            std::advance(m_current, position - m_current_position);
+            m_current_position = position;
+
+            return *m_current;
+        }
+
+        /// The beginning of the range
+        Iterator m_first;
+
+        /// Iterator pointing at the value of m_current_position
+        Iterator m_current;
+
+        /// The position of m_current in the range
+        uint32_t m_current_position;
+
+        /// The number of values in the range
+        uint32_t m_size;
+    };
+
+    /// Source returning a sequence of consecutive values
+    struct iota_source : public source
+    {
+        iota_source(return_type first, uint32_t count) :
+            m_first(first), m_count(count)
+        {
+        }
+
+        uint32_t size() const override
+        {
+            return m_count;
+        }
+
+        R get(uint32_t position) override
+        {
+            return static_cast<return_type>(m_first + position);
+        }
+
+        /// The first value of the sequence
+        return_type m_first;
+
+        /// The number of values in the sequence
+        uint32_t m_count;
+    };
+
+    /// Source returning the values stored in a file, see return_file
+    template <class File>
+    struct file_source : public source
+    {
+        file_source(const std::string& path) : m_file(path)
+        {
+        }
+
+        uint32_t size() const override
+        {
+            return m_file.size();
+        }
+
+        R get(uint32_t position) override
+        {
+            return m_file.get(position);
+        }
+
+        /// The file containing the values
+        File m_file;
+    };
+
+    /// Atomic position which can be copied, such that the return_handler
+    /// remains copyable. Copying is not thread-safe.
+    struct atomic_position : public std::atomic<uint64_t>
+    {
+        atomic_position() : std::atomic<uint64_t>(0)
+        {
+        }
+
+        atomic_position(const atomic_position& other) :
+            std::atomic<uint64_t>(other.load())
+        {
+        }
+
+        atomic_position& operator=(const atomic_position& other)
+        {
+            store(other.load());
+            return *this;
+        }
+    };
+
+    /// The positions of the per thread cursor, one for every thread which
+    /// has invoked the return_handler. The positions are stored in the
+    /// return_handler, so they are released with it and copies of the
+    /// return_handler have their own positions. Copying is not thread-safe.
+    struct thread_positions
+    {
+        thread_positions()
+        {
+        }
+
+        thread_positions(const thread_positions& other) :
+            m_positions(other.m_positions)
+        {
+        }
+
+        thread_positions& operator=(const thread_positions& other)
+        {
+            m_positions = other.m_positions;
+            return *this;
+        }
+
+        /// @return The position of the calling thread, which is then
+        ///         stepped forward
+        uint64_t next(bool repeat, uint32_t size)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            uint64_t& position = m_positions[thread_key()];
+            const uint64_t ticket = position++;
+
+            if (repeat && position == size)
+                position = 0;
+
+            return ticket;
+        }
+
+        /// @return A key unique to the calling thread, the address of a
+        ///         thread_local object avoids including <thread>
+        static const void* thread_key()
+        {
+            static thread_local char marker;
+            return &marker;
+        }
+
+        /// Remove the positions of all threads
+        void clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_positions.clear();
+        }
+
+        /// Protects the positions
+        std::mutex m_mutex;
+
+        /// The position of every thread
+        std::unordered_map<const void*, uint64_t> m_positions;
+    };
+
+    /// Wrapper for a single return value. We wrap the values to avoid the
+    /// std::vector<bool> specialization. vector<bool> is a bitset-like
+    /// container, not a container of bools, which can cause unexpected
+    /// behavior e.g. when returning references to the stored values.
+    struct slot
+    {
+        return_type m_value;
+    };
+
 private:
     /// Boolean value controlling whether we should repeat return
     /// values when reaching the end of the return value vector or
-    /// assert. True means we repeat, false means we should assert.
+    /// throw. True means we repeat, false means we should throw.
     bool m_repeat;
 
+    /// Boolean value controlling whether the return values are moved out
+    /// instead of copied when returned.
+    bool m_move_out;
+
     /// The position of the return values vector that we will
     /// return upon next invocation of the call operator. The
     /// m_positions is mutable since the call operator is a const
     /// function and we need to increment m_positions once called.
     mutable uint32_t m_position;
 
-    /// Container storing the return values to be used.
-    /// We use a deque instead of a vector to avoid a specific issue with
-    /// vector<bool>. vector<bool> is a bitset-like container, not a container
-    /// of bools, which can cause unexpected behavior when used with certain STL
-    /// algorithms. deque<bool> does not have this special behavior and is safer
-    /// to use in this context.
-    std::deque<return_type> m_returns;
+    /// The cursor used to select the next return value
+    cursor m_cursor;
+
+    /// The position used by the atomic cursor
+    mutable atomic_position m_atomic_position;
+
+    /// The positions used by the per thread cursor
+    mutable thread_positions m_thread_positions;
+
+    /// The number of return values available
+    uint32_t m_size;
+
+    /// Contiguous storage of the return values to be used. The container
+    /// is mutable since values may be moved out in the call operator.
+    mutable std::vector<slot> m_returns;
+
+    /// Source of lazily generated return values, used instead of
+    /// m_returns when set. The source is shared between copies of the
+    /// return_handler since the values only depend on the position.
+    std::shared_ptr<source> m_source;
 };
 
 /// Specialization for the case of a void function i.e. no return
@@ -214,5 +775,11 @@ public:
     void operator()() const
     {
     }
+
+    /// @return The number of bytes held, always zero
+    std::size_t memory_usage() const
+    {
+        return 0;
+    }
 };
 } // namespace stub
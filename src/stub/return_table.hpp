@@ -0,0 +1,412 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arguments.hpp"
+#include "compare_argument.hpp"
+#include "compare_call.hpp"
+#include "hash_arguments.hpp"
+#include "is_copyable.hpp"
+#include "return_handler.hpp"
+#include "unqualified_type.hpp"
+
+namespace stub
+{
+/// @brief The return_table is used in the function object to select the
+///        return value based on the arguments of a call.
+///
+/// The return values are stored in a hash table keyed by the arguments,
+/// so looking up the return value of a call has constant cost. If no
+/// return value has been set for the arguments, the return value is
+/// generated by the return_handler instead.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        return_table<uint32_t, uint64_t> table;
+///        table.set_return_for(1U, 10U).set_return_for(2U, 20U);
+///
+///        return_handler<uint32_t> fallback;
+///        fallback.set_return(0U);
+///
+///        assert(table(std::make_tuple(1U), fallback) == 10U);
+///        assert(table(std::make_tuple(2U), fallback) == 20U);
+///        assert(table(std::make_tuple(3U), fallback) == 0U);
+///
+/// The hash table is type erased and only created when the first return
+/// value is set, so std::hash is only needed for the argument types when
+/// the return_table is used.
+///
+/// Return values can also be selected by rules using the same special
+/// values as expectations, e.g. ignore(), not_nullptr() or make_compare():
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        return_table<uint32_t, uint64_t, bool> table;
+///        table.when(stub::ignore(), true).then_return(1U);
+///        table.when(5U, false).then_return(2U);
+///
+/// Rules where all values are plain values are stored in the hash table,
+/// only the rules using special values are checked one by one. Return
+/// values from the hash table therefore take precedence, after that the
+/// rules are checked in the order they were added.
+template <class R, class... Args>
+class return_table
+{
+public:
+    /// Get the unqualified version of return type.
+    using return_type = typename unqualified_type<R>::type;
+
+    /// Constructor
+    return_table() = default;
+
+    /// Copy constructor, copies the return values
+    return_table(const return_table& other) :
+        m_table(other.m_table ? other.m_table->clone() : nullptr),
+        m_rules(other.m_rules)
+    {
+    }
+
+    /// Copy assignment, copies the return values
+    return_table& operator=(const return_table& other)
+    {
+        m_table.reset(other.m_table ? other.m_table->clone() : nullptr);
+        m_rules = other.m_rules;
+        return *this;
+    }
+
+    /// Move constructor
+    return_table(return_table&& other) = default;
+
+    /// Move assignment
+    return_table& operator=(return_table&& other) = default;
+
+    /// Set the value to return when called with specific arguments. The
+    /// last argument is the return value, the other arguments are the
+    /// arguments of the call.
+    ///
+    /// @param key_and_value The arguments followed by the return value
+    ///
+    /// @return Reference to the return_table, this allows chaining
+    template <class... KeyAndValue>
+    return_table& set_return_for(KeyAndValue&&... key_and_value)
+    {
+        static_assert(sizeof...(KeyAndValue) == sizeof...(Args) + 1,
+                      "The arguments must be followed by the return value");
+        static_assert(is_copyable<return_type>::value,
+                      "The return type must be copyable");
+
+        auto tuple =
+            std::forward_as_tuple(std::forward<KeyAndValue>(key_and_value)...);
+
+        insert(tuple, return_type(std::get<sizeof...(Args)>(tuple)),
+               std::index_sequence_for<Args...>());
+
+        return *this;
+    }
+
+    /// A rule under construction, see when(...)
+    template <class... WithArgs>
+    class when_clause
+    {
+    public:
+        /// Constructor
+        when_clause(return_table& table, std::tuple<WithArgs...> with) :
+            m_table(table), m_with(std::move(with))
+        {
+        }
+
+        /// Set the value to return when the rule matches
+        ///
+        /// @param value The return value
+        ///
+        /// @return Reference to the return_table, this allows chaining
+        return_table& then_return(return_type value)
+        {
+            m_table.add_rule(m_with, std::move(value),
+                             std::index_sequence_for<WithArgs...>());
+            return m_table;
+        }
+
+    private:
+        /// The return_table the rule is added to
+        return_table& m_table;
+
+        /// The values or special values the arguments are compared with
+        std::tuple<WithArgs...> m_with;
+    };
+
+    /// Start a rule selecting a return value. The rule matches when the
+    /// arguments compare equal to the values passed, using the same
+    /// comparison as function::expect_calls(), i.e. special values such as
+    /// ignore(), not_nullptr() and make_compare() can be used. The return
+    /// value is set by calling then_return(...) on the result.
+    ///
+    /// @param with The values to compare the arguments with
+    ///
+    /// @return The rule, call then_return(...) to set the return value
+    template <class... WithArgs>
+    when_clause<typename std::decay<WithArgs>::type...>
+    when(WithArgs&&... with)
+    {
+        static_assert(sizeof...(WithArgs) == sizeof...(Args),
+                      "A value must be given for every argument");
+        static_assert(is_copyable<return_type>::value,
+                      "The return type must be copyable");
+
+        using tuple_type = std::tuple<typename std::decay<WithArgs>::type...>;
+
+        return when_clause<typename std::decay<WithArgs>::type...>(
+            *this, tuple_type(std::forward<WithArgs>(with)...));
+    }
+
+    /// Reserve space for a number of return values, to avoid rehashing
+    /// when setting many return values.
+    ///
+    /// @param size The number of return values to reserve space for
+    void reserve(std::size_t size)
+    {
+        static_assert(is_copyable<return_type>::value,
+                      "The return type must be copyable");
+
+        if (!m_table)
+        {
+            m_table.reset(new table());
+        }
+
+        m_table->reserve(size);
+    }
+
+    /// @return The number of return values set, including rules
+    std::size_t size() const
+    {
+        return (m_table ? m_table->size() : 0) + m_rules.size();
+    }
+
+    /// Generate the return value for a call
+    ///
+    /// @param args The arguments of the call
+    /// @param fallback The return_handler to use if no return value has
+    ///        been set for the arguments
+    ///
+    /// @return The return value
+    R operator()(const arguments<Args...>& args,
+                 const return_handler<R>& fallback) const
+    {
+        return lookup(args, fallback,
+                      is_copyable<return_type>());
+    }
+
+private:
+    /// Look up the return value for types that can be copied
+    R lookup(const arguments<Args...>& args,
+             const return_handler<R>& fallback, std::true_type) const
+    {
+        if (m_table)
+        {
+            const return_type* value = m_table->find(args);
+
+            if (value != nullptr)
+            {
+                return *value;
+            }
+        }
+
+        for (const auto& rule : m_rules)
+        {
+            if (rule.m_call->compare(args))
+            {
+                return rule.m_value;
+            }
+        }
+
+        return fallback();
+    }
+
+    /// Types that cannot be copied always use the return_handler
+    R lookup(const arguments<Args...>& args,
+             const return_handler<R>& fallback, std::false_type) const
+    {
+        (void)args;
+        return fallback();
+    }
+
+    /// Insert the value for the key stored in the first elements of the
+    /// tuple into the hash table
+    template <class Tuple, std::size_t... Index>
+    void insert(const Tuple& key, return_type value,
+                std::index_sequence<Index...>)
+    {
+        if (!m_table)
+        {
+            m_table.reset(new table());
+        }
+
+        m_table->insert(arguments<Args...>(std::get<Index>(key)...),
+                        std::move(value));
+    }
+
+    /// Helper used to check a pack of boolean values
+    template <bool... Values>
+    struct bool_pack
+    {
+    };
+
+    /// Whether all values in the pack are true
+    template <bool... Values>
+    using all_true =
+        std::is_same<bool_pack<true, Values...>, bool_pack<Values..., true>>;
+
+    /// Whether a rule only has plain values which can be looked up in the
+    /// hash table
+    template <class... WithArgs>
+    using is_exact = std::integral_constant<
+        bool,
+        all_true<!is_matcher<WithArgs>::value...>::value &&
+            all_true<std::is_convertible<
+                const WithArgs&, typename std::decay<Args>::type>::value...>::
+                value &&
+            all_true<is_hashable<typename std::decay<Args>::type>::value...>::
+                value>;
+
+    /// Add a rule
+    template <class... WithArgs, std::size_t... Index>
+    void add_rule(const std::tuple<WithArgs...>& with, return_type value,
+                  std::index_sequence<Index...> index)
+    {
+        add_rule(with, std::move(value), index, is_exact<WithArgs...>());
+    }
+
+    /// Add a rule with plain values to the hash table
+    template <class... WithArgs, std::size_t... Index>
+    void add_rule(const std::tuple<WithArgs...>& with, return_type value,
+                  std::index_sequence<Index...> index, std::true_type)
+    {
+        insert(with, std::move(value), index);
+    }
+
+    /// Add a rule which is checked one by one
+    template <class... WithArgs, std::size_t... Index>
+    void add_rule(const std::tuple<WithArgs...>& with, return_type value,
+                  std::index_sequence<Index...>, std::false_type)
+    {
+        m_rules.push_back(rule{
+            std::make_shared<compare_call<Args...>>(std::get<Index>(with)...),
+            std::move(value)});
+    }
+
+private:
+    /// Interface used in the type erasure
+    struct interface
+    {
+        virtual ~interface()
+        {
+        }
+
+        /// @return Pointer to the return value or nullptr if not found
+        virtual const return_type*
+        find(const arguments<Args...>& args) const = 0;
+
+        virtual void insert(arguments<Args...> args, return_type value) = 0;
+
+        virtual void reserve(std::size_t size) = 0;
+
+        virtual std::size_t size() const = 0;
+
+        virtual interface* clone() const = 0;
+    };
+
+    /// Hash table storing the return values
+    struct table : public interface
+    {
+        const return_type* find(const arguments<Args...>& args) const override
+        {
+            auto it = m_values.find(args);
+            return it == m_values.end() ? nullptr : &it->second;
+        }
+
+        void insert(arguments<Args...> args, return_type value) override
+        {
+            auto it = m_values.find(args);
+
+            if (it != m_values.end())
+            {
+                it->second = std::move(value);
+            }
+            else
+            {
+                m_values.emplace(std::move(args), std::move(value));
+            }
+        }
+
+        interface* clone() const override
+        {
+            return new table(*this);
+        }
+
+        void reserve(std::size_t size) override
+        {
+            m_values.reserve(size);
+        }
+
+        std::size_t size() const override
+        {
+            return m_values.size();
+        }
+
+        /// The return values keyed by the arguments
+        std::unordered_map<arguments<Args...>, return_type,
+                           hash_arguments<arguments<Args...>>>
+            m_values;
+    };
+
+    /// A rule which is checked for every call
+    struct rule
+    {
+        /// The comparison of the arguments. The compare_call cannot be
+        /// copied so it is shared between copies of the return_table.
+        std::shared_ptr<const compare_call<Args...>> m_call;
+
+        /// The value to return if the comparison matches
+        return_type m_value;
+    };
+
+private:
+    /// Stores the type-erased hash table
+    std::unique_ptr<interface> m_table;
+
+    /// The rules checked in order if no value is found in the hash table
+    std::vector<rule> m_rules;
+};
+
+/// Specialization for the case of a void function i.e. no return
+/// value.
+template <class... Args>
+class return_table<void, Args...>
+{
+public:
+    /// Generate the return value for a call i.e. invoke the
+    /// return_handler
+    void operator()(const arguments<Args...>& args,
+                    const return_handler<void>& fallback) const
+    {
+        (void)args;
+        fallback();
+    }
+};
+}
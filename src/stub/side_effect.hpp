@@ -0,0 +1,178 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "arguments.hpp"
+#include "inline_function.hpp"
+
+namespace stub
+{
+/// A side effect receiving the arguments of a call and the index of the
+/// call, see function::add_side_effect(...).
+template <class... Args>
+using side_effect =
+    inline_function<void(const arguments<Args...>&, uint32_t)>;
+
+/// Trait telling whether a callable can be invoked with the values of the
+/// types in the tuple.
+template <class Callable, class Tuple, class = void>
+struct is_callable_with : std::false_type
+{
+};
+
+/// Specialization chosen when the callable can be invoked
+template <class Callable, class... T>
+struct is_callable_with<Callable, std::tuple<T...>,
+                        decltype(void(std::declval<Callable&>()(
+                            std::declval<T>()...)))> : std::true_type
+{
+};
+
+/// Trait telling whether a callable can be invoked with references to the
+/// arguments of a call
+template <class Callable, class... Args>
+using is_arguments_side_effect = is_callable_with<
+    Callable,
+    std::tuple<const typename std::decay<Args>::type&...>>;
+
+/// Trait telling whether a callable can be invoked with the index of the
+/// call followed by references to the arguments of a call
+template <class Callable, class... Args>
+using is_indexed_side_effect = is_callable_with<
+    Callable,
+    std::tuple<uint32_t, const typename std::decay<Args>::type&...>>;
+
+/// Adapter invoking a callable without arguments
+template <class Callable>
+struct no_arguments_side_effect
+{
+    template <class Arguments>
+    void operator()(const Arguments& args, uint32_t index)
+    {
+        (void)args;
+        (void)index;
+        m_callable();
+    }
+
+    /// The adapted callable
+    Callable m_callable;
+};
+
+/// Adapter invoking a callable with references to the arguments of a call
+template <class Callable>
+struct arguments_side_effect
+{
+    template <class Arguments>
+    void operator()(const Arguments& args, uint32_t index)
+    {
+        (void)index;
+        invoke(args, std::make_index_sequence<
+                         std::tuple_size<Arguments>::value>());
+    }
+
+    template <class Arguments, std::size_t... Index>
+    void invoke(const Arguments& args, std::index_sequence<Index...>)
+    {
+        (void)args;
+        m_callable(std::get<Index>(args)...);
+    }
+
+    /// The adapted callable
+    Callable m_callable;
+};
+
+/// Adapter invoking a callable with the index of the call followed by
+/// references to the arguments of the call
+template <class Callable>
+struct indexed_side_effect
+{
+    template <class Arguments>
+    void operator()(const Arguments& args, uint32_t index)
+    {
+        invoke(args, index,
+               std::make_index_sequence<
+                   std::tuple_size<Arguments>::value>());
+    }
+
+    template <class Arguments, std::size_t... Index>
+    void invoke(const Arguments& args, uint32_t index,
+                std::index_sequence<Index...>)
+    {
+        (void)args;
+        m_callable(index, std::get<Index>(args)...);
+    }
+
+    /// The adapted callable
+    Callable m_callable;
+};
+
+/// Create a side effect from a callable accepting either no arguments, the
+/// arguments of the call or the index of the call followed by the
+/// arguments.
+///
+/// @param callable The callable to adapt
+///
+/// @return The side effect
+template <class... Args, class Callable>
+side_effect<Args...> make_side_effect(Callable&& callable)
+{
+    using type = typename std::decay<Callable>::type;
+
+    static_assert(is_callable_with<type, std::tuple<>>::value ||
+                      is_arguments_side_effect<type, Args...>::value ||
+                      is_indexed_side_effect<type, Args...>::value,
+                  "A side effect must accept no arguments, the arguments of "
+                  "the call or the index of the call followed by the "
+                  "arguments");
+
+    using adapter = typename std::conditional<
+        is_callable_with<type, std::tuple<>>::value,
+        no_arguments_side_effect<type>,
+        typename std::conditional<is_arguments_side_effect<type,
+                                                           Args...>::value,
+                                  arguments_side_effect<type>,
+                                  indexed_side_effect<type>>::type>::type;
+
+    return adapter{std::forward<Callable>(callable)};
+}
+
+/// @brief Interface of the worker invoking the asynchronous side effects of
+///        a function object, implemented by async_side_effects in the
+///        opt-in async_side_effects.hpp.
+template <class... Args>
+struct async_side_effects_interface
+{
+    virtual ~async_side_effects_interface()
+    {
+    }
+
+    /// Add a side effect
+    virtual void add(side_effect<Args...> effect) = 0;
+
+    /// Invoke the side effects with a copy of the arguments of a call
+    virtual void post(const arguments<Args...>& call, uint32_t index) = 0;
+
+    /// Wait for the pending side effects, keeping their exceptions for the
+    /// next drain()
+    virtual void wait() = 0;
+
+    /// Wait for the pending side effects and rethrow the first exception
+    virtual void drain() = 0;
+
+    /// @return A worker with copies of the side effects
+    virtual std::unique_ptr<async_side_effects_interface> clone() = 0;
+
+    /// @return The number of bytes held by the side effects
+    virtual std::size_t memory_usage() const = 0;
+};
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+/// @file
+///
+/// C++20 module interface unit exporting the public API of the stub
+/// headers, such that C++20 code can use:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        import stub;
+///
+///        stub::function<void(uint32_t)> my_func;
+///
+/// The headers are included in the global module fragment, so the module
+/// and the headers can be used together. The headers remain the interface
+/// for C++14 and C++17 users.
+
+module;
+
+#include "arguments.hpp"
+#include "call_digest.hpp"
+#include "call_timing.hpp"
+#include "compare.hpp"
+#include "compare_argument.hpp"
+#include "compare_arguments.hpp"
+#include "compare_call.hpp"
+#include "expect_calls.hpp"
+#include "export_calls.hpp"
+#include "format_buffer.hpp"
+#include "function.hpp"
+#include "hash_arguments.hpp"
+#include "ignore.hpp"
+#include "inline_function.hpp"
+#include "is_copyable.hpp"
+#include "make_compare.hpp"
+#include "mapped_file.hpp"
+#include "memory_budget_exceeded.hpp"
+#include "memory_usage.hpp"
+#include "not_nullptr.hpp"
+#include "print_argument.hpp"
+#include "print_arguments.hpp"
+#include "print_value.hpp"
+#include "registry.hpp"
+#include "replay.hpp"
+#include "return_exhausted.hpp"
+#include "return_file.hpp"
+#include "return_handler.hpp"
+#include "return_table.hpp"
+#include "side_effect.hpp"
+#include "trace.hpp"
+#include "trace_argument.hpp"
+#include "trace_error.hpp"
+#include "trace_stream.hpp"
+#include "unqualified_type.hpp"
+
+export module stub;
+
+export namespace stub
+{
+// Function objects and return values
+using stub::arguments;
+using stub::function;
+using stub::inline_function;
+using stub::is_copyable;
+using stub::return_exhausted;
+using stub::return_file;
+using stub::return_handler;
+using stub::return_table;
+using stub::side_effect;
+using stub::operator<<;
+
+// Expectations and matchers
+using stub::compare;
+using stub::compare_argument;
+using stub::compare_arguments;
+using stub::compare_call;
+using stub::expect_calls;
+using stub::ignore;
+using stub::is_matcher;
+using stub::make_compare;
+using stub::not_nullptr;
+
+// Printing
+using stub::format_buffer;
+using stub::print_argument;
+using stub::print_arguments;
+using stub::print_value;
+
+// Traces, digests, export and replay
+using stub::call_digest;
+using stub::export_options;
+using stub::read_trace;
+using stub::replay;
+using stub::replay_options;
+using stub::replay_result;
+using stub::replay_trace;
+using stub::trace_argument;
+using stub::trace_error;
+using stub::trace_reader;
+using stub::trace_types;
+using stub::write_csv;
+using stub::write_json_lines;
+using stub::write_trace;
+
+// Timing, memory and the registry
+using stub::call_timing;
+using stub::gap_histogram;
+using stub::heap_size;
+using stub::heap_size_of;
+using stub::mapped_file;
+using stub::memory_breakdown;
+using stub::memory_budget_exceeded;
+using stub::registry;
+using stub::registry_stats;
+}
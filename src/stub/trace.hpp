@@ -0,0 +1,452 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "arguments.hpp"
+#include "format_buffer.hpp"
+#include "function.hpp"
+#include "trace_argument.hpp"
+#include "trace_error.hpp"
+#include "trace_stream.hpp"
+
+namespace stub
+{
+/// The bytes starting a binary trace, the last byte is the version of the
+/// trace format
+static const uint8_t trace_magic[] = {'S', 'T', 'U', 'B', 'T', 'R', 'C', 1};
+
+/// @return The types of the arguments as stored in the trace header
+template <class... Args>
+inline std::vector<std::string> trace_types()
+{
+    return {trace_argument<typename std::decay<Args>::type>::type()...};
+}
+
+/// Write the header of a binary trace
+///
+/// @param out The output where the header is written
+/// @param types The types of the arguments, see trace_types()
+/// @param calls The number of calls stored in the trace
+inline void write_trace_header(trace_output& out,
+                               const std::vector<std::string>& types,
+                               uint64_t calls)
+{
+    out.write_bytes(trace_magic, sizeof(trace_magic));
+    out.write_varint(types.size());
+
+    for (const auto& type : types)
+    {
+        out.write_varint(type.size());
+        out.write_bytes((const uint8_t*)type.data(), type.size());
+    }
+
+    out.write_varint(calls);
+}
+
+/// Read the header of a binary trace, throws trace_error if the input is
+/// not a trace
+///
+/// @param in The input from where the header is read
+/// @param types The types of the arguments stored in the trace
+///
+/// @return The number of calls stored in the trace
+inline uint64_t read_trace_header(trace_input& in,
+                                  std::vector<std::string>& types)
+{
+    uint8_t magic[sizeof(trace_magic)];
+    in.read_bytes(magic, sizeof(magic));
+
+    if (!std::equal(magic, magic + sizeof(magic), trace_magic))
+        throw trace_error("Not a trace or unsupported trace version");
+
+    uint64_t arity = in.read_varint();
+
+    types.clear();
+    for (uint64_t i = 0; i < arity; ++i)
+    {
+        types.push_back(read_trace_bytes<std::string>(in));
+    }
+
+    return in.read_varint();
+}
+
+/// Write the arguments of a single call
+///
+/// @param out The output where the arguments are written
+/// @param call The arguments of the call
+template <class... T>
+inline void write_trace_call(trace_output& out, const std::tuple<T...>& call)
+{
+    // The arguments are written as the fields of a tuple
+    trace_argument<std::tuple<T...>>::write(out, call);
+}
+
+/// Read the arguments of a single call
+///
+/// @param in The input from where the arguments are read
+///
+/// @return The arguments of the call
+template <class... Args>
+inline arguments<Args...> read_trace_call(trace_input& in)
+{
+    return trace_argument<arguments<Args...>>::read(in);
+}
+
+/// Write the calls recorded by a function object as a compact binary
+/// trace.
+///
+/// The trace starts with a header containing the types of the arguments
+/// and the number of calls, followed by the arguments of each call. The
+/// arguments are encoded using the trace_argument trait, where integers
+/// are stored as variable length integers.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        stub::function<void(uint32_t, std::string)> my_func;
+///
+///        my_func(4U, "hello");
+///        my_func(5U, "world");
+///
+///        std::ofstream file("my_func.trace", std::ios::binary);
+///        stub::write_trace(file, my_func);
+///
+/// The trace can be loaded using read_trace<Args...>(...) or decoded
+/// without knowing the argument types using the trace_reader, e.g. by the
+/// stub_trace command-line tool.
+///
+/// @param out The stream where the trace is written
+/// @param function The function object whose calls are written
+template <class R, class... Args>
+inline void write_trace(std::ostream& out, const function<R(Args...)>& function)
+{
+    trace_output output(*out.rdbuf());
+    write_trace_header(output, trace_types<Args...>(), function.calls());
+
+    for (uint32_t i = 0; i < function.calls(); ++i)
+    {
+        write_trace_call(output, function.call_arguments(i));
+    }
+}
+
+/// Read the calls stored in a binary trace written by write_trace(...).
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        std::ifstream file("my_func.trace", std::ios::binary);
+///        auto calls = stub::read_trace<uint32_t, std::string>(file);
+///
+///        assert(std::get<1>(calls[0]) == "hello");
+///
+/// A trace_error is thrown if the trace is invalid or was written for
+/// other argument types.
+///
+/// @param in The stream from where the trace is read
+///
+/// @return The arguments of the calls
+template <class... Args>
+inline std::vector<arguments<Args...>> read_trace(std::istream& in)
+{
+    trace_input input(*in.rdbuf());
+
+    std::vector<std::string> types;
+    uint64_t calls = read_trace_header(input, types);
+
+    if (types != trace_types<Args...>())
+        throw trace_error("The trace was written for other argument types");
+
+    std::vector<arguments<Args...>> result;
+    for (uint64_t i = 0; i < calls; ++i)
+    {
+        result.push_back(read_trace_call<Args...>(input));
+    }
+    return result;
+}
+
+/// @brief Decodes a binary trace without knowing the C++ types of the
+///        arguments.
+///
+/// The arguments are decoded using the types stored in the trace header
+/// and formatted as text, integers in decimal, byte buffers in hex,
+/// vectors as ``[a, b]`` and tuples as ``(a, b)``.
+///
+/// Example:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        std::ifstream file("my_func.trace", std::ios::binary);
+///        stub::trace_reader reader(file);
+///
+///        std::vector<std::string> values;
+///        while (reader.read_call(values))
+///        {
+///            std::cout << values[0] << std::endl;
+///        }
+///
+class trace_reader
+{
+public:
+    /// Constructor, reads the header of the trace
+    ///
+    /// @param in The stream from where the trace is read
+    trace_reader(std::istream& in) : m_input(*in.rdbuf()), m_position(0)
+    {
+        m_calls = read_trace_header(m_input, m_types);
+
+        for (const auto& type : m_types)
+        {
+            std::size_t offset = 0;
+            m_decoders.push_back(parse(type, offset));
+
+            if (offset != type.size())
+                throw trace_error("Unknown type in the trace: " + type);
+        }
+    }
+
+    /// @return The types of the arguments as stored in the trace
+    const std::vector<std::string>& types() const
+    {
+        return m_types;
+    }
+
+    /// @return The number of calls stored in the trace
+    uint64_t calls() const
+    {
+        return m_calls;
+    }
+
+    /// @return The index of the next call to be read
+    uint64_t position() const
+    {
+        return m_position;
+    }
+
+    /// Read the next call
+    ///
+    /// @param values The arguments of the call formatted as text
+    ///
+    /// @return True if a call was read, false if all calls have been read
+    bool read_call(std::vector<std::string>& values)
+    {
+        if (m_position == m_calls)
+            return false;
+
+        values.resize(m_decoders.size());
+
+        for (std::size_t i = 0; i < m_decoders.size(); ++i)
+        {
+            m_buffer.clear();
+            decode(m_decoders[i]);
+            values[i].assign(m_buffer.data(), m_buffer.size());
+        }
+
+        ++m_position;
+        return true;
+    }
+
+private:
+    /// The kinds of values stored in a trace
+    enum class kind
+    {
+        boolean,
+        character,
+        unsigned_integer,
+        signed_integer,
+        float32,
+        float64,
+        pointer,
+        string,
+        bytes,
+        vector,
+        tuple
+    };
+
+    /// Describes how to decode a value, vectors and tuples have elements
+    struct decoder
+    {
+        kind m_kind;
+        std::vector<decoder> m_elements;
+    };
+
+    /// Parse a type string starting at the offset
+    static decoder parse(const std::string& type, std::size_t& offset)
+    {
+        static const std::pair<const char*, kind> names[] = {
+            {"bool", kind::boolean},
+            {"char", kind::character},
+            {"u8", kind::unsigned_integer},
+            {"u16", kind::unsigned_integer},
+            {"u32", kind::unsigned_integer},
+            {"u64", kind::unsigned_integer},
+            {"i8", kind::signed_integer},
+            {"i16", kind::signed_integer},
+            {"i32", kind::signed_integer},
+            {"i64", kind::signed_integer},
+            {"f32", kind::float32},
+            {"f64", kind::float64},
+            {"ptr", kind::pointer},
+            {"str", kind::string},
+            {"bytes", kind::bytes}};
+
+        if (type.compare(offset, 4, "vec<") == 0)
+        {
+            offset += 4;
+            decoder result{kind::vector, {parse(type, offset)}};
+            expect(type, offset, '>');
+            return result;
+        }
+
+        if (type.compare(offset, 1, "(") == 0)
+        {
+            ++offset;
+            decoder result{kind::tuple, {}};
+
+            while (type.compare(offset, 1, ")") != 0)
+            {
+                if (!result.m_elements.empty())
+                    expect(type, offset, ',');
+
+                result.m_elements.push_back(parse(type, offset));
+            }
+
+            ++offset;
+            return result;
+        }
+
+        // Find the end of the name and look it up
+        std::size_t end = offset;
+        while (end < type.size() && type[end] != ',' && type[end] != ')' &&
+               type[end] != '>')
+        {
+            ++end;
+        }
+
+        for (const auto& name : names)
+        {
+            if (type.compare(offset, end - offset, name.first) == 0)
+            {
+                offset = end;
+                return decoder{name.second, {}};
+            }
+        }
+
+        throw trace_error("Unknown type in the trace: " + type);
+    }
+
+    /// Consume the expected character of a type string
+    static void expect(const std::string& type, std::size_t& offset, char c)
+    {
+        if (offset >= type.size() || type[offset] != c)
+            throw trace_error("Unknown type in the trace: " + type);
+
+        ++offset;
+    }
+
+    /// Decode a value and format it into the buffer
+    void decode(const decoder& value)
+    {
+        switch (value.m_kind)
+        {
+        case kind::boolean:
+            m_buffer.append_value(m_input.read_byte() != 0);
+            break;
+        case kind::character:
+            m_buffer.append((char)m_input.read_byte());
+            break;
+        case kind::unsigned_integer:
+            m_buffer.append_value(m_input.read_varint());
+            break;
+        case kind::signed_integer:
+            m_buffer.append_value(m_input.read_zigzag());
+            break;
+        case kind::float32:
+            m_buffer.append_value(trace_argument<float>::read(m_input));
+            break;
+        case kind::float64:
+            m_buffer.append_value(trace_argument<double>::read(m_input));
+            break;
+        case kind::pointer:
+            m_buffer.append_hex((uintptr_t)m_input.read_varint());
+            break;
+        case kind::string:
+        {
+            std::string text = read_trace_bytes<std::string>(m_input);
+            m_buffer.append(text.data(), text.size());
+            break;
+        }
+        case kind::bytes:
+        {
+            std::string data = read_trace_bytes<std::string>(m_input);
+            for (char byte : data)
+            {
+                m_buffer.append("0123456789abcdef"[(uint8_t)byte >> 4]);
+                m_buffer.append("0123456789abcdef"[(uint8_t)byte & 0xf]);
+            }
+            break;
+        }
+        case kind::vector:
+        {
+            uint64_t size = m_input.read_varint();
+            m_buffer.append('[');
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                if (i != 0)
+                    m_buffer.append(", ");
+                decode(value.m_elements[0]);
+            }
+            m_buffer.append(']');
+            break;
+        }
+        case kind::tuple:
+        {
+            m_buffer.append('(');
+            for (std::size_t i = 0; i < value.m_elements.size(); ++i)
+            {
+                if (i != 0)
+                    m_buffer.append(", ");
+                decode(value.m_elements[i]);
+            }
+            m_buffer.append(')');
+            break;
+        }
+        }
+    }
+
+private:
+    /// The input from where the trace is read
+    trace_input m_input;
+
+    /// The types of the arguments
+    std::vector<std::string> m_types;
+
+    /// The decoders of the arguments
+    std::vector<decoder> m_decoders;
+
+    /// The number of calls stored in the trace
+    uint64_t m_calls;
+
+    /// The index of the next call to be read
+    uint64_t m_position;
+
+    /// Buffer used to format the values
+    format_buffer m_buffer;
+};
+}
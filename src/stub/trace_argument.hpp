@@ -0,0 +1,407 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "trace_error.hpp"
+#include "trace_stream.hpp"
+
+namespace stub
+{
+/// @brief Trait describing how an argument of type T is stored in a
+///        binary trace, see write_trace(...).
+///
+/// A specialization provides the type of the argument in the trace header
+/// and functions writing and reading a value:
+///
+/// .. code-block:: c++
+///    :linenos:
+///
+///        template <>
+///        struct trace_argument<point>
+///        {
+///            static std::string type()
+///            {
+///                return "(i32,i32)";
+///            }
+///
+///            static void write(stub::trace_output& out, const point& p)
+///            {
+///                out.write_zigzag(p.x);
+///                out.write_zigzag(p.y);
+///            }
+///
+///            static point read(stub::trace_input& in)
+///            {
+///                int32_t x = (int32_t)in.read_zigzag();
+///                int32_t y = (int32_t)in.read_zigzag();
+///                return point{x, y};
+///            }
+///        };
+///
+/// The type string is used to decode traces without knowing the C++ types,
+/// e.g. by trace_reader, so it must describe the written bytes using the
+/// types of the built-in specializations:
+///
+///   - ``bool`` and ``char`` are stored as a single byte.
+///   - ``u8`` to ``u64`` and ``i8`` to ``i64`` are unsigned and signed
+///     integers stored as (zigzag encoded) variable length integers.
+///   - ``f32`` and ``f64`` are floating point values.
+///   - ``ptr`` is the value of a pointer.
+///   - ``str`` and ``bytes`` are a length followed by characters or bytes.
+///   - ``vec<T>`` is a length followed by the values.
+///   - ``(T,U,...)`` are the values one after the other.
+///
+template <class T, class Enable = void>
+struct trace_argument;
+
+/// Specialization for bool
+template <>
+struct trace_argument<bool>
+{
+    static std::string type()
+    {
+        return "bool";
+    }
+
+    static void write(trace_output& out, bool value)
+    {
+        out.write_byte(value ? 1 : 0);
+    }
+
+    static bool read(trace_input& in)
+    {
+        return in.read_byte() != 0;
+    }
+};
+
+/// Specialization for char
+template <>
+struct trace_argument<char>
+{
+    static std::string type()
+    {
+        return "char";
+    }
+
+    static void write(trace_output& out, char value)
+    {
+        out.write_byte((uint8_t)value);
+    }
+
+    static char read(trace_input& in)
+    {
+        return (char)in.read_byte();
+    }
+};
+
+/// Specialization for unsigned integers
+template <class T>
+struct trace_argument<
+    T, typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_unsigned<T>::value &&
+                               !std::is_same<T, bool>::value &&
+                               !std::is_same<T, char>::value>::type>
+{
+    static std::string type()
+    {
+        return "u" + std::to_string(8 * sizeof(T));
+    }
+
+    static void write(trace_output& out, T value)
+    {
+        out.write_varint(value);
+    }
+
+    static T read(trace_input& in)
+    {
+        uint64_t value = in.read_varint();
+
+        if (value > std::numeric_limits<T>::max())
+            throw trace_error("Integer out of range in the trace");
+
+        return (T)value;
+    }
+};
+
+/// Specialization for signed integers
+template <class T>
+struct trace_argument<
+    T, typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_signed<T>::value &&
+                               !std::is_same<T, char>::value>::type>
+{
+    static std::string type()
+    {
+        return "i" + std::to_string(8 * sizeof(T));
+    }
+
+    static void write(trace_output& out, T value)
+    {
+        out.write_zigzag(value);
+    }
+
+    static T read(trace_input& in)
+    {
+        int64_t value = in.read_zigzag();
+
+        if (value < std::numeric_limits<T>::min() ||
+            value > std::numeric_limits<T>::max())
+        {
+            throw trace_error("Integer out of range in the trace");
+        }
+
+        return (T)value;
+    }
+};
+
+/// Specialization for float and double, the values are stored in little
+/// endian byte order
+template <class T>
+struct trace_argument<
+    T, typename std::enable_if<std::is_same<T, float>::value ||
+                               std::is_same<T, double>::value>::type>
+{
+    using bits_type = typename std::conditional<sizeof(T) == 4, uint32_t,
+                                                uint64_t>::type;
+
+    static_assert(sizeof(T) == sizeof(bits_type),
+                  "Unsupported floating point representation");
+
+    static std::string type()
+    {
+        return "f" + std::to_string(8 * sizeof(T));
+    }
+
+    static void write(trace_output& out, T value)
+    {
+        bits_type bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        out.write_fixed(bits, sizeof(bits));
+    }
+
+    static T read(trace_input& in)
+    {
+        bits_type bits = (bits_type)in.read_fixed(sizeof(bits_type));
+
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+};
+
+/// Specialization for enumerations, stored as the underlying type
+template <class T>
+struct trace_argument<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    using underlying_type = typename std::underlying_type<T>::type;
+
+    static std::string type()
+    {
+        return trace_argument<underlying_type>::type();
+    }
+
+    static void write(trace_output& out, T value)
+    {
+        trace_argument<underlying_type>::write(out, (underlying_type)value);
+    }
+
+    static T read(trace_input& in)
+    {
+        return (T)trace_argument<underlying_type>::read(in);
+    }
+};
+
+/// Specialization for pointers, only the value of the pointer is stored
+template <class T>
+struct trace_argument<T*>
+{
+    static std::string type()
+    {
+        return "ptr";
+    }
+
+    static void write(trace_output& out, T* value)
+    {
+        out.write_varint((uintptr_t)value);
+    }
+
+    static T* read(trace_input& in)
+    {
+        return (T*)(uintptr_t)in.read_varint();
+    }
+};
+
+/// Read a length followed by the bytes into a container. The bytes are
+/// read in blocks so a corrupted length does not allocate a huge buffer.
+template <class Container>
+inline Container read_trace_bytes(trace_input& in)
+{
+    uint64_t size = in.read_varint();
+
+    Container container;
+    while (container.size() < size)
+    {
+        std::size_t offset = container.size();
+        std::size_t block =
+            (std::size_t)std::min<uint64_t>(size - offset, 65536U);
+
+        container.resize(offset + block);
+        in.read_bytes((uint8_t*)&container[offset], block);
+    }
+    return container;
+}
+
+/// Specialization for std::string
+template <>
+struct trace_argument<std::string>
+{
+    static std::string type()
+    {
+        return "str";
+    }
+
+    static void write(trace_output& out, const std::string& value)
+    {
+        out.write_varint(value.size());
+        out.write_bytes((const uint8_t*)value.data(), value.size());
+    }
+
+    static std::string read(trace_input& in)
+    {
+        return read_trace_bytes<std::string>(in);
+    }
+};
+
+/// Specialization for byte buffers
+template <>
+struct trace_argument<std::vector<uint8_t>>
+{
+    static std::string type()
+    {
+        return "bytes";
+    }
+
+    static void write(trace_output& out, const std::vector<uint8_t>& value)
+    {
+        out.write_varint(value.size());
+        out.write_bytes(value.data(), value.size());
+    }
+
+    static std::vector<uint8_t> read(trace_input& in)
+    {
+        return read_trace_bytes<std::vector<uint8_t>>(in);
+    }
+};
+
+/// Specialization for std::vector
+template <class T, class Allocator>
+struct trace_argument<std::vector<T, Allocator>>
+{
+    static std::string type()
+    {
+        return "vec<" + trace_argument<T>::type() + ">";
+    }
+
+    static void write(trace_output& out,
+                      const std::vector<T, Allocator>& value)
+    {
+        out.write_varint(value.size());
+        for (const auto& element : value)
+        {
+            trace_argument<T>::write(out, element);
+        }
+    }
+
+    static std::vector<T, Allocator> read(trace_input& in)
+    {
+        uint64_t size = in.read_varint();
+
+        std::vector<T, Allocator> value;
+        for (uint64_t i = 0; i < size; ++i)
+        {
+            value.push_back(trace_argument<T>::read(in));
+        }
+        return value;
+    }
+};
+
+/// Specialization for std::tuple
+template <class... T>
+struct trace_argument<std::tuple<T...>>
+{
+    static std::string type()
+    {
+        std::string types[] = {trace_argument<T>::type()..., ""};
+
+        std::string result = "(";
+        for (std::size_t i = 0; i < sizeof...(T); ++i)
+        {
+            result += (i == 0 ? "" : ",") + types[i];
+        }
+        return result + ")";
+    }
+
+    static void write(trace_output& out, const std::tuple<T...>& value)
+    {
+        write(out, value, std::index_sequence_for<T...>());
+    }
+
+    static std::tuple<T...> read(trace_input& in)
+    {
+        // The elements of a braced initializer list are evaluated in order
+        (void)in;
+        return std::tuple<T...>{trace_argument<T>::read(in)...};
+    }
+
+private:
+    template <std::size_t... Index>
+    static void write(trace_output& out, const std::tuple<T...>& value,
+                      std::index_sequence<Index...>)
+    {
+        (void)out;
+        (void)value;
+
+        // The elements of a braced list are evaluated in order
+        std::initializer_list<int>{
+            (trace_argument<T>::write(out, std::get<Index>(value)), 0)...};
+    }
+};
+
+/// Specialization for std::pair
+template <class First, class Second>
+struct trace_argument<std::pair<First, Second>>
+{
+    static std::string type()
+    {
+        return "(" + trace_argument<First>::type() + "," +
+               trace_argument<Second>::type() + ")";
+    }
+
+    static void write(trace_output& out, const std::pair<First, Second>& value)
+    {
+        trace_argument<First>::write(out, value.first);
+        trace_argument<Second>::write(out, value.second);
+    }
+
+    static std::pair<First, Second> read(trace_input& in)
+    {
+        First first = trace_argument<First>::read(in);
+        Second second = trace_argument<Second>::read(in);
+        return std::pair<First, Second>(std::move(first), std::move(second));
+    }
+};
+}
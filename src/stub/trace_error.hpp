@@ -0,0 +1,26 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace stub
+{
+
+/// Exception thrown when a binary trace cannot be written or read, e.g.
+/// if the trace is truncated or was written for other argument types.
+struct trace_error : public std::runtime_error
+{
+    /// Constructor
+    ///
+    /// @param message Description of the error
+    trace_error(const std::string& message) : std::runtime_error(message)
+    {
+    }
+};
+
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+#include "trace_error.hpp"
+
+namespace stub
+{
+/// Writes the bytes of a binary trace to a std::streambuf.
+///
+/// Unsigned integers are written as variable length integers (LEB128)
+/// using 7 bits per byte, so small values take up a single byte. Signed
+/// integers are zigzag encoded before being written as variable length
+/// integers, so small negative values are also short.
+class trace_output
+{
+public:
+    /// Constructor
+    ///
+    /// @param buffer The buffer where the bytes are written
+    trace_output(std::streambuf& buffer) : m_buffer(buffer)
+    {
+    }
+
+    /// Write a single byte
+    void write_byte(uint8_t value)
+    {
+        if (m_buffer.sputc((char)value) == std::streambuf::traits_type::eof())
+            throw trace_error("Could not write the trace");
+    }
+
+    /// Write a number of bytes
+    void write_bytes(const uint8_t* data, std::size_t size)
+    {
+        if (m_buffer.sputn((const char*)data, (std::streamsize)size) !=
+            (std::streamsize)size)
+        {
+            throw trace_error("Could not write the trace");
+        }
+    }
+
+    /// Write an unsigned integer as a variable length integer
+    void write_varint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            write_byte((uint8_t)(value | 0x80));
+            value >>= 7;
+        }
+        write_byte((uint8_t)value);
+    }
+
+    /// Write a signed integer as a zigzag encoded variable length integer
+    void write_zigzag(int64_t value)
+    {
+        write_varint(((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+    }
+
+    /// Write a fixed size unsigned integer in little endian byte order
+    void write_fixed(uint64_t value, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            write_byte((uint8_t)(value >> (8 * i)));
+        }
+    }
+
+private:
+    /// The buffer where the bytes are written
+    std::streambuf& m_buffer;
+};
+
+/// Reads the bytes of a binary trace from a std::streambuf, see
+/// trace_output for a description of the encoding. A trace_error is
+/// thrown if the trace ends unexpectedly or contains invalid values.
+class trace_input
+{
+public:
+    /// Constructor
+    ///
+    /// @param buffer The buffer from where the bytes are read
+    trace_input(std::streambuf& buffer) : m_buffer(buffer)
+    {
+    }
+
+    /// @return True if all bytes have been read otherwise false
+    bool at_end()
+    {
+        return m_buffer.sgetc() == std::streambuf::traits_type::eof();
+    }
+
+    /// Read a single byte
+    uint8_t read_byte()
+    {
+        auto value = m_buffer.sbumpc();
+
+        if (value == std::streambuf::traits_type::eof())
+            throw trace_error("Unexpected end of the trace");
+
+        return (uint8_t)value;
+    }
+
+    /// Read a number of bytes
+    void read_bytes(uint8_t* data, std::size_t size)
+    {
+        if (m_buffer.sgetn((char*)data, (std::streamsize)size) !=
+            (std::streamsize)size)
+        {
+            throw trace_error("Unexpected end of the trace");
+        }
+    }
+
+    /// Read an unsigned variable length integer
+    uint64_t read_varint()
+    {
+        uint64_t value = 0;
+
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            uint8_t byte = read_byte();
+            value |= (uint64_t)(byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+
+        throw trace_error("Invalid variable length integer in the trace");
+    }
+
+    /// Read a zigzag encoded signed variable length integer
+    int64_t read_zigzag()
+    {
+        uint64_t value = read_varint();
+        return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+    }
+
+    /// Read a fixed size unsigned integer in little endian byte order
+    uint64_t read_fixed(std::size_t size)
+    {
+        uint64_t value = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value |= (uint64_t)read_byte() << (8 * i);
+        }
+        return value;
+    }
+
+private:
+    /// The buffer from where the bytes are read
+    std::streambuf& m_buffer;
+};
+}
@@ -0,0 +1,32 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+// Consumer of the stub module, built and run when STUB_BUILD_MODULE is
+// enabled. The test fails with a non-zero exit code.
+
+#include <cstdint>
+#include <iostream>
+
+import stub;
+
+int main()
+{
+    stub::function<uint32_t(uint32_t)> function;
+    function.set_return(4U);
+
+    if (function(1U) != 4U)
+    {
+        std::cerr << "Unexpected return value" << std::endl;
+        return 1;
+    }
+
+    if (!function.expect_calls().with(1U))
+    {
+        std::cerr << "Unexpected calls: " << function << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
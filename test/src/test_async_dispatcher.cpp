@@ -0,0 +1,89 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/async_dispatcher.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_async_dispatcher, order)
+{
+    std::vector<uint32_t> executed;
+
+    stub::async_dispatcher<std::function<void()>> dispatcher(4);
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        dispatcher.post([&executed, i]() { executed.push_back(i); });
+    }
+
+    dispatcher.drain();
+
+    ASSERT_EQ(100U, executed.size());
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(i, executed[i]);
+    }
+
+    EXPECT_EQ(0U, dispatcher.pending());
+}
+
+TEST(test_async_dispatcher, worker_thread)
+{
+    std::thread::id worker;
+
+    stub::async_dispatcher<std::function<void()>> dispatcher;
+    dispatcher.post([&worker]() { worker = std::this_thread::get_id(); });
+    dispatcher.drain();
+
+    EXPECT_NE(std::this_thread::get_id(), worker);
+}
+
+TEST(test_async_dispatcher, exception)
+{
+    uint32_t count = 0;
+
+    stub::async_dispatcher<std::function<void()>> dispatcher;
+    dispatcher.post([]() { throw std::runtime_error("first"); });
+    dispatcher.post([]() { throw std::runtime_error("second"); });
+    dispatcher.post([&count]() { ++count; });
+
+    try
+    {
+        dispatcher.drain();
+        FAIL() << "Expected an exception";
+    }
+    catch (const std::runtime_error& e)
+    {
+        EXPECT_EQ(std::string("first"), e.what());
+    }
+
+    EXPECT_EQ(1U, count);
+
+    // The exception is only reported once
+    dispatcher.drain();
+}
+
+TEST(test_async_dispatcher, destructor)
+{
+    uint32_t count = 0;
+
+    {
+        stub::async_dispatcher<std::function<void()>> dispatcher(2);
+
+        for (uint32_t i = 0; i < 10; ++i)
+        {
+            dispatcher.post([&count]() { ++count; });
+        }
+    }
+
+    // Pending tasks are executed before the dispatcher is destroyed
+    EXPECT_EQ(10U, count);
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/call_digest.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+stub::function<void(uint32_t, std::string)> make_log(uint32_t calls)
+{
+    stub::function<void(uint32_t, std::string)> function;
+
+    for (uint32_t i = 0; i < calls; ++i)
+    {
+        function(i, std::to_string(i * 7));
+    }
+
+    return function;
+}
+}
+
+TEST(test_call_digest, equal)
+{
+    auto a = make_log(1000);
+    auto b = make_log(1000);
+
+    stub::call_digest digest_a(a, 100);
+    stub::call_digest digest_b(b, 100);
+
+    EXPECT_EQ(1000U, digest_a.calls());
+    EXPECT_EQ(10U, digest_a.segments());
+    EXPECT_TRUE(digest_a == digest_b);
+    EXPECT_EQ(10U, digest_a.first_difference(digest_b));
+
+    // The hash only depends on the recorded calls
+    EXPECT_EQ(digest_a.hash(), stub::call_digest(make_log(1000), 100).hash());
+}
+
+TEST(test_call_digest, first_difference)
+{
+    auto golden = make_log(1000);
+    stub::call_digest golden_digest(golden, 100);
+
+    for (uint32_t changed : {0U, 99U, 100U, 555U, 999U})
+    {
+        auto current = make_log(1000);
+        current.clear_calls();
+
+        for (uint32_t i = 0; i < 1000; ++i)
+        {
+            current(i == changed ? i + 1 : i, std::to_string(i * 7));
+        }
+
+        stub::call_digest digest(current, 100);
+
+        EXPECT_TRUE(digest != golden_digest);
+        EXPECT_EQ(changed / 100, digest.first_difference(golden_digest));
+        EXPECT_EQ(changed / 100, golden_digest.first_difference(digest));
+    }
+}
+
+TEST(test_call_digest, different_length)
+{
+    stub::call_digest longer(make_log(250), 100);
+    stub::call_digest shorter(make_log(200), 100);
+    stub::call_digest partial(make_log(230), 100);
+
+    EXPECT_TRUE(longer != shorter);
+    EXPECT_EQ(2U, longer.first_difference(shorter));
+    EXPECT_EQ(2U, shorter.first_difference(longer));
+    EXPECT_EQ(2U, partial.first_difference(longer));
+}
+
+TEST(test_call_digest, different_types)
+{
+    stub::function<void(uint32_t)> a;
+    stub::function<void(uint64_t)> b;
+
+    a(1U);
+    b(1U);
+
+    EXPECT_TRUE(stub::call_digest(a) != stub::call_digest(b));
+}
+
+TEST(test_call_digest, incremental)
+{
+    auto function = make_log(300);
+    stub::call_digest digest(100);
+    digest.set_types(stub::trace_types<uint32_t, std::string>());
+
+    for (uint32_t i = 0; i < function.calls(); ++i)
+    {
+        digest.add(function.call_arguments(i));
+
+        // A copy continues from the same state
+        if (i == 150)
+        {
+            stub::call_digest copy = digest;
+            digest = copy;
+        }
+    }
+
+    EXPECT_TRUE(digest == stub::call_digest(function, 100));
+}
+
+TEST(test_call_digest, save_load)
+{
+    stub::call_digest digest(make_log(1000), 64);
+
+    std::stringstream stream;
+    digest.save(stream);
+
+    auto loaded = stub::call_digest::load(stream);
+
+    EXPECT_TRUE(digest == loaded);
+    EXPECT_EQ(64U, loaded.segment_size());
+    EXPECT_EQ(digest.segments(), loaded.segments());
+    EXPECT_EQ(digest.prefix_hash(7), loaded.prefix_hash(7));
+
+    // Calls added after loading continue the last segment
+    auto function = make_log(1010);
+    for (uint32_t i = 1000; i < function.calls(); ++i)
+    {
+        loaded.add(function.call_arguments(i));
+    }
+
+    EXPECT_TRUE(loaded == stub::call_digest(function, 64));
+
+    std::stringstream invalid("not a digest");
+    EXPECT_THROW(stub::call_digest::load(invalid), stub::trace_error);
+}
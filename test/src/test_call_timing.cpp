@@ -0,0 +1,93 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/call_timing.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+TEST(test_call_timing, buckets)
+{
+    uint32_t bucket_count = stub::gap_histogram::bucket_count;
+
+    // Small values have a bucket each
+    for (uint64_t value = 0; value < 32; ++value)
+    {
+        EXPECT_EQ(value, stub::gap_histogram::bucket_index(value));
+        EXPECT_EQ(value, stub::gap_histogram::bucket_highest((uint32_t)value));
+    }
+
+    // Every value lies in its bucket and the relative error is bounded
+    for (uint64_t value = 32; value < (1ULL << 62); value = value * 3 + 1)
+    {
+        uint32_t index = stub::gap_histogram::bucket_index(value);
+        uint64_t highest = stub::gap_histogram::bucket_highest(index);
+
+        EXPECT_LE(value, highest);
+        EXPECT_LE((double)(highest - value), (double)value / 16.0);
+        EXPECT_LT(index, bucket_count);
+    }
+
+    uint64_t max = std::numeric_limits<uint64_t>::max();
+    EXPECT_EQ(bucket_count - 1, stub::gap_histogram::bucket_index(max));
+}
+
+TEST(test_call_timing, histogram)
+{
+    stub::gap_histogram histogram;
+    EXPECT_EQ(0U, histogram.count());
+    EXPECT_EQ(0U, histogram.value_at_percentile(50.0));
+
+    for (uint64_t value = 1; value <= 1000; ++value)
+    {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(1000U, histogram.count());
+    EXPECT_EQ(1U, histogram.min());
+    EXPECT_EQ(1000U, histogram.max());
+    EXPECT_EQ(500U, histogram.mean());
+
+    uint64_t median = histogram.value_at_percentile(50.0);
+    EXPECT_LE(500U, median);
+    EXPECT_GE(500U + 500U / 16U, median);
+
+    EXPECT_EQ(1U, histogram.value_at_percentile(0.0));
+    EXPECT_EQ(1000U, histogram.value_at_percentile(100.0));
+
+    histogram.clear();
+    EXPECT_EQ(0U, histogram.count());
+
+    // The rank is rounded up for small counts
+    histogram.record(10U);
+    histogram.record(20U);
+    histogram.record(30U);
+
+    EXPECT_EQ(10U, histogram.value_at_percentile(33.0));
+    EXPECT_EQ(20U, histogram.value_at_percentile(50.0));
+    EXPECT_EQ(30U, histogram.value_at_percentile(99.0));
+}
+
+TEST(test_call_timing, timing)
+{
+    using clock = stub::call_timing::clock;
+
+    stub::call_timing timing;
+    EXPECT_FALSE(timing.enabled());
+
+    auto start = clock::now();
+    timing.record(start);
+    timing.record(start + std::chrono::microseconds(10));
+    timing.record(start + std::chrono::microseconds(30));
+
+    EXPECT_EQ(3U, timing.calls());
+    EXPECT_EQ(30000, timing.elapsed(2).count());
+    EXPECT_EQ(2U, timing.gaps().count());
+    EXPECT_EQ(10000U, timing.gaps().min());
+    EXPECT_EQ(20000U, timing.gaps().max());
+}
@@ -55,3 +55,14 @@ TEST(test_compare_argument, string)
     std::string str = "hello";
     EXPECT_TRUE(stub::compare_argument(str, "hello"));
 }
+
+TEST(test_compare_argument, is_matcher)
+{
+    auto compare = stub::make_compare([](uint32_t v) { return v == 1U; });
+
+    EXPECT_TRUE(stub::is_matcher<stub::ignore>::value);
+    EXPECT_TRUE(stub::is_matcher<stub::not_nullptr>::value);
+    EXPECT_TRUE(stub::is_matcher<decltype(compare)>::value);
+    EXPECT_FALSE(stub::is_matcher<uint32_t>::value);
+    EXPECT_FALSE(stub::is_matcher<std::string>::value);
+}
@@ -4,6 +4,11 @@
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
 #include <stub/compare_arguments.hpp>
+#include <stub/make_compare.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
 
 #include <gtest/gtest.h>
 
@@ -52,3 +57,27 @@ TEST(test_compare_arguments, string)
 
     EXPECT_TRUE(stub::compare_arguments(t1, t2));
 }
+
+TEST(test_compare_arguments, short_circuit)
+{
+    uint32_t compared = 0;
+    auto count = stub::make_compare(
+        [&compared](uint32_t) -> bool
+        {
+            ++compared;
+            return true;
+        });
+
+    auto actual = std::make_tuple(1U, 2U, 3U);
+
+    EXPECT_TRUE(
+        stub::compare_arguments(actual, std::make_tuple(1U, count, count)));
+    EXPECT_EQ(2U, compared);
+
+    // No values are compared after the first difference
+    EXPECT_FALSE(
+        stub::compare_arguments(actual, std::make_tuple(0U, count, count)));
+    EXPECT_EQ(2U, compared);
+
+    EXPECT_TRUE(stub::compare_arguments(std::make_tuple(), std::make_tuple()));
+}
@@ -0,0 +1,151 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/export_calls.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+template <class T>
+std::string json(const T& value)
+{
+    stub::format_buffer buffer;
+    stub::export_value(buffer, value);
+    return std::string(buffer.data(), buffer.size());
+}
+
+enum class color
+{
+    red,
+    green
+};
+}
+
+TEST(test_export_calls, export_value)
+{
+    EXPECT_EQ("true", json(true));
+    EXPECT_EQ("\"a\"", json('a'));
+    EXPECT_EQ("200", json((uint8_t)200));
+    EXPECT_EQ("-4", json(-4));
+    EXPECT_EQ("0.5", json(0.5));
+    EXPECT_EQ("null", json(std::numeric_limits<double>::infinity()));
+    EXPECT_EQ("1", json(color::green));
+    EXPECT_EQ("\"0xdead\"", json((uint8_t*)0xdead));
+    EXPECT_EQ("\"a\\\"b\\n\\u0001\"", json(std::string("a\"b\n\x01")));
+    EXPECT_EQ("\"01ff\"", json(std::vector<uint8_t>{0x01, 0xff}));
+    EXPECT_EQ("[1,2]", json(std::vector<uint32_t>{1, 2}));
+    EXPECT_EQ("[[\"x\"],[]]",
+              json(std::vector<std::vector<std::string>>{{"x"}, {}}));
+}
+
+TEST(test_export_calls, exact_floating_point)
+{
+    EXPECT_EQ(0.1, std::stod(json(0.1)));
+    EXPECT_EQ(1.0 / 3.0, std::stod(json(1.0 / 3.0)));
+}
+
+TEST(test_export_calls, json_lines)
+{
+    stub::function<void(uint32_t, const std::string&)> function;
+
+    function(4U, "hello");
+    function(5U, "world");
+
+    std::stringstream stream;
+    stub::write_json_lines(stream, function);
+
+    EXPECT_EQ("{\"arg0\":4,\"arg1\":\"hello\"}\n"
+              "{\"arg0\":5,\"arg1\":\"world\"}\n",
+              stream.str());
+
+    stub::export_options options;
+    options.m_index = true;
+
+    std::stringstream indexed;
+    stub::write_json_lines(indexed, function, options);
+
+    EXPECT_EQ("{\"index\":0,\"arg0\":4,\"arg1\":\"hello\"}\n"
+              "{\"index\":1,\"arg0\":5,\"arg1\":\"world\"}\n",
+              indexed.str());
+}
+
+TEST(test_export_calls, json_lines_no_arguments)
+{
+    stub::function<void()> function;
+    function();
+
+    stub::export_options options;
+    options.m_index = true;
+
+    std::stringstream stream;
+    stub::write_json_lines(stream, function, options);
+
+    EXPECT_EQ("{\"index\":0}\n", stream.str());
+}
+
+TEST(test_export_calls, csv)
+{
+    stub::function<void(uint32_t, std::string, std::vector<uint32_t>)>
+        function;
+
+    function(4U, "hello", {1});
+    function(5U, "a,\"b\"", {1, 2});
+
+    stub::export_options options;
+    options.m_index = true;
+
+    std::stringstream stream;
+    stub::write_csv(stream, function, options);
+
+    EXPECT_EQ("index,arg0,arg1,arg2\n"
+              "0,4,hello,[1]\n"
+              "1,5,\"a,\"\"b\"\"\",\"[1,2]\"\n",
+              stream.str());
+}
+
+TEST(test_export_calls, timestamps)
+{
+    stub::function<void(uint32_t)> function;
+    function.enable_timing();
+
+    function(4U);
+    function(5U);
+
+    stub::export_options options;
+    options.m_index = true;
+    options.m_timestamp = true;
+
+    std::stringstream json_lines;
+    stub::write_json_lines(json_lines, function, options);
+
+    std::string elapsed = std::to_string(function.timing().elapsed(1).count());
+
+    EXPECT_EQ("{\"index\":0,\"timestamp\":0,\"arg0\":4}\n"
+              "{\"index\":1,\"timestamp\":" +
+                  elapsed + ",\"arg0\":5}\n",
+              json_lines.str());
+
+    std::stringstream csv;
+    stub::write_csv(csv, function, options);
+
+    EXPECT_EQ("index,timestamp,arg0\n0,0,4\n1," + elapsed + ",5\n",
+              csv.str());
+
+    // Without timing the timestamps are left out
+    stub::function<void(uint32_t)> untimed;
+    untimed(4U);
+
+    std::stringstream untimed_csv;
+    stub::write_csv(untimed_csv, untimed, options);
+
+    EXPECT_EQ("index,arg0\n0,4\n", untimed_csv.str());
+}
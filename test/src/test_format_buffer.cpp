@@ -0,0 +1,91 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/format_buffer.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+template <class T>
+void check_value(T value)
+{
+    stub::format_buffer buffer;
+    buffer.append_value(value);
+
+    std::stringstream stream;
+    stream << value;
+
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+}
+}
+
+TEST(test_format_buffer, append)
+{
+    stub::format_buffer buffer;
+    EXPECT_EQ(0U, buffer.size());
+
+    buffer.append("Arg ");
+    buffer.append('x');
+    buffer.append("yz", 1);
+
+    EXPECT_EQ("Arg xy", std::string(buffer.data(), buffer.size()));
+
+    buffer.clear();
+    EXPECT_EQ(0U, buffer.size());
+}
+
+TEST(test_format_buffer, numbers)
+{
+    check_value(0);
+    check_value(-1);
+    check_value(42U);
+    check_value(std::numeric_limits<int8_t>::min());
+    check_value(std::numeric_limits<int16_t>::min());
+    check_value(std::numeric_limits<int32_t>::min());
+    check_value(std::numeric_limits<int64_t>::min());
+    check_value(std::numeric_limits<uint64_t>::max());
+    check_value((short)-7);
+    check_value('a');
+    check_value((uint8_t)65);
+    check_value(true);
+    check_value(0.0);
+    check_value(3.14);
+    check_value(-2.5f);
+    check_value(1e-7);
+    check_value(123456789.0);
+    check_value(0.1L);
+}
+
+TEST(test_format_buffer, hex)
+{
+    stub::format_buffer buffer;
+    buffer.append_hex(0xdeadbeef);
+    buffer.append(' ');
+    buffer.append_hex(0);
+
+    std::stringstream stream;
+    stream << std::hex << std::showbase << (uintptr_t)0xdeadbeef << " "
+           << (uintptr_t)0;
+
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+}
+
+TEST(test_format_buffer, stream)
+{
+    stub::format_buffer buffer;
+    buffer.append_value(std::string("okok"));
+    buffer.stream() << 42 << "!";
+
+    std::stringstream stream;
+    buffer.write_to(stream);
+
+    EXPECT_EQ("okok42!", stream.str());
+}
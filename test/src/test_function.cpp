@@ -3,8 +3,19 @@
 //
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
+#include <stub/async_side_effects.hpp>
 #include <stub/function.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 /// Test that the call operator works as expected
@@ -510,3 +521,407 @@ TEST(test_function, boolean_return_value)
     EXPECT_TRUE(b());
     EXPECT_TRUE(b.expect_calls().with().to_bool());
 }
+
+TEST(test_function, move_only_return_value)
+{
+    stub::function<std::unique_ptr<uint32_t>(uint32_t)> function;
+    function.set_return(std::unique_ptr<uint32_t>(new uint32_t(2U)),
+                        std::unique_ptr<uint32_t>(new uint32_t(3U)));
+
+    auto a = function(1U);
+    auto b = function(2U);
+
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(*a, 2U);
+    EXPECT_EQ(*b, 3U);
+    EXPECT_TRUE(function.expect_calls().with(1U).with(2U).to_bool());
+}
+
+TEST(test_function, set_return_range_iota)
+{
+    std::vector<bool> values = {true, false};
+
+    stub::function<bool(uint32_t)> function;
+    function.set_return_range(values.begin(), values.end());
+
+    EXPECT_TRUE(function(1U));
+    EXPECT_FALSE(function(2U));
+    EXPECT_TRUE(function(3U));
+
+    stub::function<uint32_t()> counter;
+    counter.set_return_iota(10U, 2U);
+
+    EXPECT_EQ(counter(), 10U);
+    EXPECT_EQ(counter(), 11U);
+    EXPECT_EQ(counter(), 10U);
+}
+
+TEST(test_function, set_return_for)
+{
+    stub::function<int(uint64_t)> function;
+    function.set_return_for(1U, 10).set_return_for(2U, 20);
+    function.set_return(-1);
+
+    EXPECT_EQ(function(1U), 10);
+    EXPECT_EQ(function(2U), 20);
+    EXPECT_EQ(function(3U), -1);
+    EXPECT_EQ(function(2U), 20);
+
+    EXPECT_TRUE(
+        function.expect_calls().with(1U).with(2U).with(3U).with(2U).to_bool());
+
+    // Clearing the function also clears the return values
+    function.clear();
+    function.set_return(0);
+
+    EXPECT_EQ(function(1U), 0);
+}
+
+TEST(test_function, set_return_for_no_arguments)
+{
+    stub::function<bool()> function;
+    function.set_return_for(true);
+
+    EXPECT_TRUE(function());
+}
+
+TEST(test_function, when_then_return)
+{
+    stub::function<int(uint32_t, uint32_t)> function;
+    function.when(stub::ignore(), 2U).then_return(1);
+    function.when(3U, stub::make_compare([](uint32_t v) { return v > 3U; }))
+        .then_return(2);
+    function.set_return(0);
+
+    EXPECT_EQ(function(1U, 2U), 1);
+    EXPECT_EQ(function(3U, 4U), 2);
+    EXPECT_EQ(function(3U, 3U), 0);
+    EXPECT_EQ(function(4U, 4U), 0);
+}
+
+TEST(test_function, side_effects)
+{
+    stub::function<void(uint32_t)> function;
+
+    uint32_t count = 0;
+    std::string log;
+
+    function.add_side_effect([&count]() { ++count; });
+    function.add_side_effect(std::function<void()>([&log]() { log += "a"; }));
+
+    function(1U);
+    function(2U);
+
+    EXPECT_EQ(count, 2U);
+    EXPECT_EQ(log, "aa");
+}
+
+TEST(test_function, side_effects_with_arguments)
+{
+    stub::function<void(uint32_t, const std::string&)> function;
+
+    uint32_t calls = 0;
+    uint32_t sum = 0;
+    std::vector<uint32_t> indices;
+    std::vector<const std::string*> strings;
+
+    function.add_side_effect([&calls, &function]()
+                             { calls = function.calls(); });
+
+    function.add_side_effect([&sum](const uint32_t& value, const std::string&)
+                             { sum += value; });
+
+    function.add_side_effect(
+        [&indices, &strings](uint32_t index, const uint32_t&,
+                             const std::string& s)
+        {
+            indices.push_back(index);
+            strings.push_back(&s);
+        });
+
+    function(2U, "a");
+    function(3U, "b");
+
+    // Side effects without arguments run before the call is stored
+    EXPECT_EQ(calls, 1U);
+
+    EXPECT_EQ(sum, 5U);
+    EXPECT_EQ(indices, std::vector<uint32_t>({0U, 1U}));
+
+    // The side effects see the stored arguments
+    EXPECT_EQ(strings.back(), &std::get<1>(function.call_arguments(1)));
+}
+
+TEST(test_function, side_effects_no_arguments_index)
+{
+    stub::function<void()> function;
+
+    std::vector<uint32_t> indices;
+    function.add_side_effect([&indices](uint32_t index)
+                             { indices.push_back(index); });
+
+    function();
+    function();
+
+    EXPECT_EQ(indices, std::vector<uint32_t>({0U, 1U}));
+}
+
+TEST(test_function, async_side_effects)
+{
+    stub::function<uint32_t(std::vector<uint8_t>)> function;
+    function.set_return(1U);
+
+    uint32_t sum = 0;
+    std::vector<uint32_t> indices;
+    std::thread::id worker;
+
+    function.add_async_side_effect(
+        [&sum, &worker](const std::vector<uint8_t>& data)
+        {
+            worker = std::this_thread::get_id();
+            for (auto v : data)
+            {
+                sum += v;
+            }
+        });
+
+    function.add_async_side_effect([&indices](uint32_t index,
+                                              const std::vector<uint8_t>&)
+                                   { indices.push_back(index); });
+
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(function(std::vector<uint8_t>(100, 1)), 1U);
+    }
+
+    function.drain();
+
+    EXPECT_EQ(sum, 1000U);
+    EXPECT_EQ(indices.size(), 10U);
+    EXPECT_EQ(indices.back(), 9U);
+    EXPECT_NE(worker, std::this_thread::get_id());
+
+    // Copies get their own worker
+    auto copy = function;
+    copy(std::vector<uint8_t>(10, 1));
+    copy.drain();
+
+    EXPECT_EQ(sum, 1010U);
+}
+
+TEST(test_function, async_side_effects_move)
+{
+    std::atomic<uint32_t> count(0);
+
+    stub::function<void(uint32_t)> function;
+    function.add_async_side_effect(
+        [&count](uint32_t)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++count;
+        });
+
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        function(i);
+    }
+
+    // The pending side effects run before the members are moved
+    stub::function<void(uint32_t)> moved(std::move(function));
+    function.drain();
+
+    EXPECT_EQ(count, 50U);
+    EXPECT_EQ(moved.calls(), 50U);
+
+    for (uint32_t i = 0; i < 50; ++i)
+    {
+        moved(i);
+    }
+
+    // Also when assigning
+    function = std::move(moved);
+    moved.drain();
+
+    EXPECT_EQ(count, 100U);
+    EXPECT_EQ(function.calls(), 100U);
+}
+
+namespace
+{
+// Stream buffer counting the number of writes
+struct counting_streambuf : public std::stringbuf
+{
+    std::streamsize xsputn(const char* data, std::streamsize size) override
+    {
+        ++m_writes;
+        return std::stringbuf::xsputn(data, size);
+    }
+
+    uint32_t m_writes = 0;
+};
+}
+
+// Test that calls can be printed incrementally in chunks
+TEST(test_function, print_calls)
+{
+    stub::function<void(uint32_t, uint32_t)> function;
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        function(i, i * 2);
+    }
+
+    std::stringstream all;
+    all << function;
+
+    // Printing in small chunks gives the same output using several writes
+    counting_streambuf buffer;
+    std::ostream chunked(&buffer);
+    function.print_calls(chunked, 0, function.calls(), 64);
+
+    EXPECT_EQ(all.str(), buffer.str());
+    EXPECT_LT(10U, buffer.m_writes);
+
+    std::stringstream range;
+    function.print_calls(range, 98, 1000);
+
+    EXPECT_EQ(range.str(), "Number of calls: 100\n"
+                           "Call 98:\n"
+                           "Arg 0: 98\n"
+                           "Arg 1: 196\n"
+                           "Call 99:\n"
+                           "Arg 0: 99\n"
+                           "Arg 1: 198\n");
+
+    std::stringstream filtered;
+    function.print_calls(
+        filtered, 0, 50,
+        [](uint32_t index, const std::tuple<uint32_t, uint32_t>& call)
+        { return index % 20 == 0 && std::get<1>(call) > 0; });
+
+    EXPECT_EQ(filtered.str(), "Number of calls: 100\n"
+                              "Call 20:\n"
+                              "Arg 0: 20\n"
+                              "Arg 1: 40\n"
+                              "Call 40:\n"
+                              "Arg 0: 40\n"
+                              "Arg 1: 80\n");
+}
+
+// Test that calls can be timed
+TEST(test_function, timing)
+{
+    stub::function<void(uint32_t)> function;
+    EXPECT_FALSE(function.timing().enabled());
+
+    function.enable_timing();
+
+    function(1U);
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    function(2U);
+
+    EXPECT_EQ(2U, function.timing().calls());
+    EXPECT_LE(2000000, function.timing().elapsed(1).count());
+    EXPECT_EQ(1U, function.timing().gaps().count());
+    EXPECT_LE(2000000U, function.timing().gaps().min());
+
+    std::stringstream stream;
+    stream << function;
+
+    EXPECT_EQ(0U, stream.str().find("Number of calls: 2\nCall gaps: min "));
+    EXPECT_NE(std::string::npos, stream.str().find("Call 0 at 0 ns:\n"));
+
+    // The format_buffer overload prints the same text
+    stub::format_buffer buffer;
+    function.print(buffer);
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+
+    function.clear_calls();
+    EXPECT_EQ(0U, function.timing().calls());
+
+    function.disable_timing();
+    function(3U);
+    EXPECT_EQ(0U, function.timing().calls());
+
+    // The recorded calls have no timestamps, so timing cannot be enabled
+    EXPECT_THROW(function.enable_timing(), std::logic_error);
+    EXPECT_FALSE(function.timing().enabled());
+
+    std::stringstream untimed;
+    untimed << function;
+    EXPECT_EQ("Number of calls: 1\nCall 0:\nArg 0: 3\n", untimed.str());
+}
+
+// Test that the memory held by the call log is reported
+TEST(test_function, memory_usage)
+{
+    stub::function<void(uint32_t)> function;
+    EXPECT_EQ(0U, function.memory_usage());
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        function(i);
+    }
+
+    EXPECT_LE(100 * sizeof(uint32_t), function.memory_usage());
+}
+
+// Test that the heap memory owned by the arguments is included
+TEST(test_function, memory_details)
+{
+    stub::function<bool(std::vector<uint8_t>)> function;
+    function.set_return(true);
+    function.add_side_effect([]() {});
+
+    function(std::vector<uint8_t>(1000));
+    function(std::vector<uint8_t>(1000));
+
+    auto memory = function.memory_details();
+    EXPECT_LE(2 * sizeof(std::vector<uint8_t>), memory.m_call_log);
+    EXPECT_EQ(2000U, memory.m_arguments);
+    EXPECT_LE(sizeof(bool), memory.m_return_values);
+    EXPECT_LT(0U, memory.m_side_effects);
+    EXPECT_EQ(0U, memory.m_timing);
+    EXPECT_EQ(memory.total(), function.memory_usage());
+
+    EXPECT_LT(0U, function.expect_calls()
+                      .with(std::vector<uint8_t>())
+                      .memory_usage());
+
+    // A side effect too large for the inline buffer is on the heap
+    std::array<char, 100> large;
+    large.fill('a');
+    function.add_side_effect([large]() { (void)large; });
+
+    EXPECT_LE(memory.m_side_effects + sizeof(large),
+              function.memory_details().m_side_effects);
+}
+
+// Test that exceeding the memory budget throws
+TEST(test_function, memory_budget)
+{
+    stub::function<void(std::vector<uint8_t>)> function;
+    function.set_memory_budget(10000);
+    EXPECT_EQ(10000U, function.memory_budget());
+
+    for (uint32_t i = 0; i < 9; ++i)
+    {
+        function(std::vector<uint8_t>(1000));
+    }
+
+    EXPECT_THROW(function(std::vector<uint8_t>(1000)),
+                 stub::memory_budget_exceeded);
+
+    // The call is recorded before throwing
+    EXPECT_EQ(10U, function.calls());
+
+    // Clearing the calls releases the budget
+    function.clear_calls();
+    function(std::vector<uint8_t>(1000));
+
+    // Removing the budget
+    function.set_memory_budget(0);
+    function(std::vector<uint8_t>(100000));
+    EXPECT_EQ(2U, function.calls());
+}
@@ -0,0 +1,40 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/hash_arguments.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(test_hash_arguments, empty)
+{
+    stub::hash_arguments<std::tuple<>> hash;
+    EXPECT_EQ(hash(std::make_tuple()), hash(std::make_tuple()));
+}
+
+TEST(test_hash_arguments, equal_arguments)
+{
+    using arguments = std::tuple<uint32_t, std::string, bool>;
+    stub::hash_arguments<arguments> hash;
+
+    arguments a(4U, "hello", true);
+    arguments b(4U, "hello", true);
+    arguments c(4U, "hello", false);
+    arguments d(5U, "hello", true);
+
+    EXPECT_EQ(hash(a), hash(b));
+    EXPECT_NE(hash(a), hash(c));
+    EXPECT_NE(hash(a), hash(d));
+}
+
+TEST(test_hash_arguments, order)
+{
+    using arguments = std::tuple<uint32_t, uint32_t>;
+    stub::hash_arguments<arguments> hash;
+
+    EXPECT_NE(hash(arguments(1U, 2U)), hash(arguments(2U, 1U)));
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/inline_function.hpp>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(test_inline_function, empty)
+{
+    stub::inline_function<void()> f;
+    EXPECT_FALSE((bool)f);
+}
+
+TEST(test_inline_function, invoke)
+{
+    uint32_t count = 0;
+    stub::inline_function<void()> f = [&count]() { ++count; };
+
+    ASSERT_TRUE((bool)f);
+
+    f();
+    f();
+    EXPECT_EQ(2U, count);
+}
+
+TEST(test_inline_function, arguments_and_return_value)
+{
+    stub::inline_function<std::string(const std::string&, uint32_t)> f =
+        [](const std::string& s, uint32_t n)
+    {
+        std::string result;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            result += s;
+        }
+        return result;
+    };
+
+    EXPECT_EQ("abab", f("ab", 2U));
+}
+
+TEST(test_inline_function, mutable_state)
+{
+    stub::inline_function<uint32_t()> f = [count = 0U]() mutable
+    { return ++count; };
+
+    EXPECT_EQ(1U, f());
+    EXPECT_EQ(2U, f());
+
+    // Copies have their own state
+    auto g = f;
+    EXPECT_EQ(3U, g());
+    EXPECT_EQ(3U, f());
+}
+
+TEST(test_inline_function, std_function)
+{
+    uint32_t count = 0;
+    std::function<void()> function = [&count]() { ++count; };
+
+    stub::inline_function<void()> f = function;
+    f();
+
+    EXPECT_EQ(1U, count);
+}
+
+TEST(test_inline_function, lifetime)
+{
+    auto counter = std::make_shared<uint32_t>(0U);
+
+    {
+        stub::inline_function<void()> f = [counter]() { ++(*counter); };
+        EXPECT_EQ(2, counter.use_count());
+
+        stub::inline_function<void()> copy = f;
+        EXPECT_EQ(3, counter.use_count());
+
+        stub::inline_function<void()> moved = std::move(copy);
+        moved();
+        EXPECT_EQ(1U, *counter);
+
+        f = stub::inline_function<void()>();
+        moved = f;
+    }
+
+    EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(test_inline_function, heap_fallback)
+{
+    // Callables larger than the capacity are allocated on the heap
+    std::array<char, 100> buffer;
+    buffer.fill('a');
+
+    auto counter = std::make_shared<uint32_t>(0U);
+    auto large = [buffer, counter]() { return buffer[99] + (*counter)++; };
+
+    using function_type = stub::inline_function<int()>;
+    EXPECT_FALSE(function_type::stored_inline<decltype(large)>());
+
+    EXPECT_EQ(0U, function_type().heap_size());
+    EXPECT_EQ(0U, function_type([]() { return 0; }).heap_size());
+
+    {
+        function_type f = large;
+        EXPECT_EQ(sizeof(large), f.heap_size());
+        EXPECT_EQ(3, counter.use_count());
+        EXPECT_EQ('a', f());
+
+        function_type copy = f;
+        EXPECT_EQ(4, counter.use_count());
+        EXPECT_EQ('a' + 1, copy());
+
+        function_type moved = std::move(copy);
+        EXPECT_EQ(4, counter.use_count());
+        EXPECT_EQ('a' + 2, moved());
+
+        f = moved;
+        EXPECT_EQ(4, counter.use_count());
+    }
+
+    EXPECT_EQ(2, counter.use_count());
+}
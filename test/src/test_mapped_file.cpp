@@ -0,0 +1,56 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/mapped_file.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+
+#include <gtest/gtest.h>
+
+TEST(test_mapped_file, map)
+{
+    const std::string path = "test_mapped_file.bin";
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "hello";
+    }
+
+    {
+        stub::mapped_file file(path);
+
+        ASSERT_EQ(5U, file.size());
+        EXPECT_EQ(std::string("hello"),
+                  std::string((const char*)file.data(), file.size()));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_mapped_file, empty)
+{
+    const std::string path = "test_mapped_file_empty.bin";
+
+    {
+        std::ofstream file(path, std::ios::binary);
+    }
+
+    {
+        stub::mapped_file file(path);
+
+        EXPECT_EQ(0U, file.size());
+        EXPECT_EQ(nullptr, file.data());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_mapped_file, missing)
+{
+    EXPECT_THROW(stub::mapped_file("this_file_does_not_exist.bin"),
+                 std::system_error);
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/memory_usage.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+struct packet
+{
+    std::vector<uint8_t> m_payload;
+};
+}
+
+namespace stub
+{
+template <>
+struct heap_size<packet>
+{
+    static std::size_t get(const packet& value)
+    {
+        return value.m_payload.capacity();
+    }
+};
+}
+
+TEST(test_memory_usage, heap_size)
+{
+    EXPECT_EQ(0U, stub::heap_size_of(42U));
+
+    // Short strings are stored inside the string object
+    EXPECT_EQ(0U, stub::heap_size_of(std::string("a")));
+
+    std::string text(1000, 'a');
+    EXPECT_EQ(text.capacity() + 1, stub::heap_size_of(text));
+
+    std::vector<uint32_t> numbers(100);
+    EXPECT_EQ(numbers.capacity() * sizeof(uint32_t),
+              stub::heap_size_of(numbers));
+
+    std::vector<std::string> strings(2, text);
+    EXPECT_EQ(strings.capacity() * sizeof(std::string) +
+                  2 * (text.capacity() + 1),
+              stub::heap_size_of(strings));
+
+    std::vector<bool> bits(80);
+    EXPECT_LE(10U, stub::heap_size_of(bits));
+    EXPECT_GT(80U, stub::heap_size_of(bits));
+
+    std::unique_ptr<uint64_t> pointer(new uint64_t(1));
+    EXPECT_EQ(sizeof(uint64_t), stub::heap_size_of(pointer));
+    EXPECT_EQ(0U, stub::heap_size_of(std::unique_ptr<uint64_t>()));
+
+    auto tuple = std::make_tuple(1U, numbers, std::make_pair(text, 2));
+    EXPECT_EQ(stub::heap_size_of(numbers) + stub::heap_size_of(text),
+              stub::heap_size_of(tuple));
+
+    // User types can specialize the trait
+    packet value{std::vector<uint8_t>(500)};
+    EXPECT_EQ(500U, stub::heap_size_of(value));
+    EXPECT_EQ(1000U,
+              stub::heap_size_of(std::vector<packet>(2, value)) -
+                  2 * sizeof(packet));
+}
+
+TEST(test_memory_usage, breakdown)
+{
+    stub::memory_breakdown memory;
+    EXPECT_EQ(0U, memory.total());
+
+    memory.m_call_log = 1;
+    memory.m_arguments = 2;
+    memory.m_return_values = 3;
+    memory.m_side_effects = 4;
+    memory.m_timing = 5;
+    EXPECT_EQ(15U, memory.total());
+}
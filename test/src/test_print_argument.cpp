@@ -5,6 +5,8 @@
 
 #include <stub/print_argument.hpp>
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(test_print_argument, non_pointer)
@@ -26,3 +28,13 @@ TEST(test_print_argument, pointer)
 
     EXPECT_EQ(stream.str(), "Arg 5: 0xdeadbeef\n");
 }
+
+TEST(test_print_argument, byte_buffer)
+{
+    std::stringstream stream;
+
+    std::vector<uint8_t> v = {0x01, 0x02, 0xff};
+    stub::print_argument(stream, 1, v);
+
+    EXPECT_EQ(stream.str(), "Arg 1: 3 bytes: 0102ff (fnv1a 0x42cf182f)\n");
+}
@@ -73,3 +73,31 @@ TEST(test_print_arguments, pointers)
                             "Arg 2: 0xdead3333\nArg 3: 0xdead4444\n"
                             "Arg 4: 0xdead5555\n");
 }
+
+TEST(test_print_arguments, format_buffer)
+{
+    std::stringstream stream;
+    stub::format_buffer buffer;
+
+    char* p = (char*)0xdead1111;
+    auto t = std::make_tuple(43U, true, 3.14, stub_testing::my_type(), p);
+    stub::print_arguments(stream, t);
+    stub::print_arguments(buffer, t);
+
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+}
+
+TEST(test_print_arguments, pointer_followed_by_integer)
+{
+    // The pointer is printed as hex, but the following arguments are not
+    std::stringstream stream;
+    stub::format_buffer buffer;
+
+    char* p = (char*)0xdead1111;
+    auto t = std::make_tuple(p, 20U);
+    stub::print_arguments(stream, t);
+    stub::print_arguments(buffer, t);
+
+    EXPECT_EQ(stream.str(), "Arg 0: 0xdead1111\nArg 1: 20\n");
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/print_value.hpp>
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+template <class T>
+std::string print(const T& value)
+{
+    std::stringstream stream;
+    stub::print_value(stream, value);
+
+    // The format_buffer produces the same text
+    stub::format_buffer buffer;
+    stub::print_value(buffer, value);
+    EXPECT_EQ(stream.str(), std::string(buffer.data(), buffer.size()));
+
+    return stream.str();
+}
+}
+
+TEST(test_print_value, traits)
+{
+    EXPECT_TRUE(stub::is_streamable<uint32_t>::value);
+    EXPECT_TRUE(stub::is_streamable<std::string>::value);
+    EXPECT_FALSE(stub::is_streamable<std::vector<uint8_t>>::value);
+
+    EXPECT_TRUE(stub::is_byte_buffer<std::string>::value);
+    EXPECT_TRUE((stub::is_byte_buffer<std::array<uint8_t, 4>>::value));
+    EXPECT_TRUE(stub::is_byte_buffer<std::vector<char>>::value);
+    EXPECT_FALSE(stub::is_byte_buffer<std::vector<uint32_t>>::value);
+    EXPECT_FALSE(stub::is_byte_buffer<uint32_t>::value);
+
+    EXPECT_TRUE(stub::is_range<std::list<uint32_t>>::value);
+    EXPECT_FALSE(stub::is_range<uint32_t>::value);
+}
+
+TEST(test_print_value, streamed)
+{
+    EXPECT_EQ("42", print(42U));
+    EXPECT_EQ("hello", print(std::string("hello")));
+}
+
+TEST(test_print_value, bytes)
+{
+    std::vector<uint8_t> empty;
+    EXPECT_EQ("0 bytes:  (fnv1a 0x811c9dc5)", print(empty));
+
+    std::vector<uint8_t> small = {0x01, 0x02, 0xff};
+    EXPECT_EQ("3 bytes: 0102ff (fnv1a 0x42cf182f)", print(small));
+
+    std::vector<uint8_t> large(4096);
+    for (uint32_t i = 0; i < large.size(); ++i)
+    {
+        large[i] = (uint8_t)i;
+    }
+
+    EXPECT_EQ("4096 bytes: 000102030405060708090a0b0c0d0e0f..."
+              "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff (fnv1a 0xd9384dc5)",
+              print(large));
+}
+
+TEST(test_print_value, long_string)
+{
+    std::string text(64, 'a');
+    EXPECT_EQ(text, print(text));
+
+    std::string long_text(1000, 'a');
+    std::string printed = print(long_text);
+
+    EXPECT_EQ(0U, printed.find("1000 bytes: 6161"));
+    EXPECT_GT(120U, printed.size());
+}
+
+TEST(test_print_value, ranges)
+{
+    std::vector<uint32_t> small = {1, 2, 3};
+    EXPECT_EQ("3 values: {1, 2, 3}", print(small));
+
+    std::list<std::string> strings = {"a", "b"};
+    EXPECT_EQ("2 values: {a, b}", print(strings));
+
+    std::vector<uint32_t> large(100);
+    for (uint32_t i = 0; i < large.size(); ++i)
+    {
+        large[i] = i;
+    }
+
+    EXPECT_EQ("100 values: {0, 1, 2, 3, 4, 5, 6, 7, ..., "
+              "92, 93, 94, 95, 96, 97, 98, 99}",
+              print(large));
+
+    std::vector<std::vector<uint8_t>> nested = {{0xab}};
+    EXPECT_EQ("1 values: {1 bytes: ab (fnv1a 0xae0bd42a)}", print(nested));
+}
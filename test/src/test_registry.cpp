@@ -0,0 +1,196 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/function.hpp>
+#include <stub/registry.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+// Enables the registry for the duration of a test
+struct enable_registry
+{
+    enable_registry()
+    {
+        stub::registry::instance().enable();
+    }
+
+    ~enable_registry()
+    {
+        stub::registry::instance().disable();
+    }
+};
+}
+
+TEST(test_registry, disabled)
+{
+    std::size_t size = stub::registry::instance().size();
+
+    stub::function<void(uint32_t)> function;
+    function.set_name("not registered");
+
+    EXPECT_FALSE(function.registered());
+    EXPECT_EQ("", function.stub_name());
+    EXPECT_EQ(size, stub::registry::instance().size());
+}
+
+TEST(test_registry, register_and_unregister)
+{
+    enable_registry enable;
+    std::size_t size = stub::registry::instance().size();
+
+    {
+        stub::function<void(uint32_t)> function;
+        EXPECT_TRUE(function.registered());
+        EXPECT_EQ(size + 1, stub::registry::instance().size());
+
+        function.set_name("send");
+        EXPECT_EQ("send", function.stub_name());
+
+        // Copies are registered with the same name
+        stub::function<void(uint32_t)> copy = function;
+        EXPECT_EQ("send", copy.stub_name());
+        EXPECT_EQ(size + 2, stub::registry::instance().size());
+
+        // Assignment keeps the name of the assigned-to function
+        stub::function<void(uint32_t)> other;
+        other.set_name("other");
+        other = function;
+        EXPECT_EQ("other", other.stub_name());
+    }
+
+    EXPECT_EQ(size, stub::registry::instance().size());
+}
+
+TEST(test_registry, report)
+{
+    enable_registry enable;
+
+    stub::function<void(uint32_t)> hot;
+    hot.set_name("hot");
+
+    stub::function<bool(std::vector<uint8_t>)> big;
+    big.set_name("big");
+    big.set_return(true);
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        hot(i);
+    }
+
+    big(std::vector<uint8_t>(10));
+    big(std::vector<uint8_t>(10));
+
+    // The peak is kept when the calls are removed
+    hot.clear_calls();
+    hot(1U);
+
+    std::vector<stub::registry_stats> stats;
+    for (const auto& stub : stub::registry::instance().stats())
+    {
+        if (stub.m_name == "hot" || stub.m_name == "big")
+            stats.push_back(stub);
+    }
+
+    ASSERT_EQ(2U, stats.size());
+
+    // Sorted by the largest number of bytes held
+    EXPECT_EQ("hot", stats[0].m_name);
+    EXPECT_EQ(1U, stats[0].m_calls);
+    EXPECT_EQ(1000U, stats[0].m_peak_calls);
+    EXPECT_EQ(hot.memory_usage(), stats[0].m_bytes);
+    EXPECT_LE(1000 * sizeof(uint32_t), stats[0].m_peak_bytes);
+
+    EXPECT_EQ("big", stats[1].m_name);
+    EXPECT_EQ(2U, stats[1].m_calls);
+    EXPECT_EQ(2U, stats[1].m_peak_calls);
+
+    std::stringstream stream;
+    stub::registry::instance().report(stream);
+
+    EXPECT_EQ(0U, stream.str().find("Registered stubs: "));
+    EXPECT_NE(std::string::npos,
+              stream.str().find("\nhot: 1 calls (peak 1000), "));
+}
+
+TEST(test_registry, peak_on_assignment)
+{
+    enable_registry enable;
+
+    stub::function<void(uint32_t)> function;
+    function.set_name("assigned");
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        function(i);
+    }
+
+    // The peak is kept when the calls are replaced by an assignment
+    function = stub::function<void(uint32_t)>();
+    function(1U);
+
+    uint32_t found = 0;
+    for (const auto& stub : stub::registry::instance().stats())
+    {
+        if (stub.m_name != "assigned")
+            continue;
+
+        EXPECT_EQ(1U, stub.m_calls);
+        EXPECT_EQ(100U, stub.m_peak_calls);
+        ++found;
+    }
+
+    EXPECT_EQ(1U, found);
+}
+
+TEST(test_registry, destroyed)
+{
+    enable_registry enable;
+    stub::registry::instance().clear_destroyed();
+
+    std::size_t peak_bytes = 0;
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        stub::function<void(uint32_t)> function;
+        function.set_name("short lived");
+
+        for (uint32_t j = 0; j <= i * 100; ++j)
+        {
+            function(j);
+        }
+
+        peak_bytes = function.memory_usage();
+    }
+
+    std::vector<stub::registry_stats> stats =
+        stub::registry::instance().stats();
+
+    // The destroyed stubs are summed up per name
+    ASSERT_EQ(1U, stats.size());
+    EXPECT_EQ("short lived", stats[0].m_name);
+    EXPECT_EQ(3U, stats[0].m_destroyed);
+    EXPECT_EQ(1U + 101U + 201U, stats[0].m_calls);
+    EXPECT_EQ(201U, stats[0].m_peak_calls);
+    EXPECT_EQ(0U, stats[0].m_bytes);
+    EXPECT_EQ(peak_bytes, stats[0].m_peak_bytes);
+
+    std::stringstream stream;
+    stub::registry::instance().report(stream);
+
+    EXPECT_EQ(0U, stream.str().find("Registered stubs: 0, destroyed: 3, "));
+    EXPECT_NE(std::string::npos,
+              stream.str().find("\nshort lived (3 destroyed): 303 calls "
+                                "(peak 201), 0 bytes (peak "));
+
+    stub::registry::instance().clear_destroyed();
+    EXPECT_TRUE(stub::registry::instance().stats().empty());
+}
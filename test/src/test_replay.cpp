@@ -0,0 +1,80 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/replay.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_replay, function)
+{
+    stub::function<void(uint32_t, const std::string&)> recorded;
+
+    recorded(1U, "a");
+    recorded(2U, "b");
+    recorded(3U, "c");
+
+    // Replaying into another stub gives the same calls
+    stub::function<void(uint32_t, const std::string&)> real;
+
+    stub::replay_options options;
+    options.m_iterations = 2;
+
+    auto result = stub::replay(recorded, real, options);
+
+    EXPECT_EQ(6U, result.m_calls);
+    EXPECT_EQ(6U, real.calls());
+    EXPECT_EQ(recorded.call_arguments(2), real.call_arguments(2));
+    EXPECT_EQ(recorded.call_arguments(0), real.call_arguments(3));
+
+    EXPECT_LE(result.m_min_latency, result.m_median_latency);
+    EXPECT_LE(result.m_median_latency, result.m_p99_latency);
+    EXPECT_LE(result.m_p99_latency, result.m_max_latency);
+    EXPECT_LE(result.m_max_latency, result.m_duration);
+    EXPECT_LT(0.0, result.calls_per_second());
+}
+
+TEST(test_replay, without_latency)
+{
+    std::vector<std::tuple<uint32_t>> calls = {std::make_tuple(1U),
+                                               std::make_tuple(2U)};
+
+    uint32_t sum = 0;
+
+    stub::replay_options options;
+    options.m_measure_latency = false;
+
+    auto result =
+        stub::replay(calls, [&sum](uint32_t value) { sum += value; }, options);
+
+    EXPECT_EQ(3U, sum);
+    EXPECT_EQ(2U, result.m_calls);
+    EXPECT_EQ(0, result.m_max_latency.count());
+}
+
+TEST(test_replay, trace)
+{
+    stub::function<void(uint32_t)> recorded;
+
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        recorded(i);
+    }
+
+    std::stringstream stream;
+    stub::write_trace(stream, recorded);
+
+    std::vector<uint32_t> values;
+    auto result = stub::replay_trace<uint32_t>(
+        stream, [&values](uint32_t value) { values.push_back(value); });
+
+    EXPECT_EQ(100U, result.m_calls);
+    ASSERT_EQ(100U, values.size());
+    EXPECT_EQ(99U, values.back());
+}
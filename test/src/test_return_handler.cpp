@@ -3,8 +3,17 @@
 //
 // Distributed under the "BSD License". See the accompanying LICENSE.rst file.
 
+#include <stub/return_file.hpp>
 #include <stub/return_handler.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(test_return_handler, void)
@@ -72,3 +81,379 @@ TEST(test_return_handler, api)
         EXPECT_EQ("4U", r());
     }
 }
+
+TEST(test_return_handler, bool_values)
+{
+    // Bool values are stored in a wrapper to avoid the std::vector<bool>
+    // specialization, so references to the values must be stable
+    stub::return_handler<const bool&> r;
+    r.set_return(true, false, true);
+
+    const bool& a = r();
+    const bool& b = r();
+    const bool& c = r();
+
+    EXPECT_TRUE(a);
+    EXPECT_FALSE(b);
+    EXPECT_TRUE(c);
+
+    // We wrap around to the first value
+    EXPECT_EQ(&a, &r());
+}
+
+TEST(test_return_handler, exhausted)
+{
+    // Invoking the return_handler with no return value left throws
+    stub::return_handler<uint32_t> r;
+    EXPECT_THROW(r(), stub::return_exhausted);
+
+    r.set_return(1U, 2U).no_repeat();
+    EXPECT_EQ(1U, r());
+    EXPECT_EQ(2U, r());
+    EXPECT_THROW(r(), std::out_of_range);
+}
+
+TEST(test_return_handler, move_only)
+{
+    stub::return_handler<std::unique_ptr<uint32_t>> r;
+    r.set_return(std::unique_ptr<uint32_t>(new uint32_t(3U)),
+                 std::unique_ptr<uint32_t>(new uint32_t(4U)));
+
+    std::unique_ptr<uint32_t> a = r();
+    std::unique_ptr<uint32_t> b = r();
+
+    ASSERT_TRUE(a);
+    ASSERT_TRUE(b);
+    EXPECT_EQ(3U, *a);
+    EXPECT_EQ(4U, *b);
+}
+
+TEST(test_return_handler, move_only_container)
+{
+    // The container declares a copy constructor, but the elements cannot
+    // be copied
+    using buffers = std::vector<std::unique_ptr<uint32_t>>;
+
+    buffers first;
+    first.emplace_back(new uint32_t(3U));
+
+    stub::return_handler<buffers> r;
+    r.set_return(std::move(first), buffers()).move_out();
+
+    buffers a = r();
+    buffers b = r();
+
+    ASSERT_EQ(1U, a.size());
+    EXPECT_EQ(3U, *a[0]);
+    EXPECT_TRUE(b.empty());
+}
+
+namespace
+{
+struct copy_counter
+{
+    copy_counter(uint32_t& copies) : m_copies(&copies)
+    {
+    }
+
+    copy_counter(const copy_counter& other) : m_copies(other.m_copies)
+    {
+        ++(*m_copies);
+    }
+
+    copy_counter(copy_counter&& other) = default;
+
+    copy_counter& operator=(const copy_counter& other) = default;
+
+    uint32_t* m_copies;
+};
+}
+
+TEST(test_return_handler, move_out)
+{
+    // Copyable values are copied unless move_out() is used
+    {
+        uint32_t copies = 0;
+        stub::return_handler<copy_counter> r;
+        r.set_return(copy_counter(copies));
+
+        copies = 0;
+        copy_counter a = r();
+        copy_counter b = r();
+        (void)a;
+        (void)b;
+
+        EXPECT_EQ(2U, copies);
+    }
+
+    {
+        uint32_t copies = 0;
+        stub::return_handler<copy_counter> r;
+        r.set_return(copy_counter(copies), copy_counter(copies)).move_out();
+
+        copies = 0;
+        copy_counter a = r();
+        copy_counter b = r();
+        (void)a;
+        (void)b;
+
+        EXPECT_EQ(0U, copies);
+    }
+
+    // Large buffers are moved out
+    {
+        stub::return_handler<std::vector<uint8_t>> r;
+        r.set_return(std::vector<uint8_t>(1000, 'a'),
+                     std::vector<uint8_t>(10, 'b'))
+            .move_out();
+
+        EXPECT_EQ(std::vector<uint8_t>(1000, 'a'), r());
+        EXPECT_EQ(std::vector<uint8_t>(10, 'b'), r());
+    }
+}
+
+TEST(test_return_handler, range)
+{
+    // Random access iterators
+    {
+        std::vector<uint32_t> values = {1U, 2U, 3U};
+
+        stub::return_handler<uint32_t> r;
+        r.set_return_range(values.begin(), values.end());
+
+        EXPECT_EQ(1U, r());
+        EXPECT_EQ(2U, r());
+
+        // The values are not copied
+        values[2] = 4U;
+
+        EXPECT_EQ(4U, r());
+        EXPECT_EQ(1U, r());
+    }
+
+    // Forward iterators
+    {
+        std::list<uint32_t> values = {5U, 6U, 7U};
+
+        stub::return_handler<uint32_t> r;
+        r.set_return_range(values.begin(), values.end());
+
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(5U, r());
+            EXPECT_EQ(6U, r());
+            EXPECT_EQ(7U, r());
+        }
+    }
+
+    // With no_repeat
+    {
+        const uint32_t values[] = {1U, 2U};
+
+        stub::return_handler<uint32_t> r;
+        r.set_return_range(std::begin(values), std::end(values)).no_repeat();
+
+        EXPECT_EQ(1U, r());
+        EXPECT_EQ(2U, r());
+
+        // Switch back to values
+        r.set_return(3U);
+        EXPECT_EQ(3U, r());
+        EXPECT_EQ(3U, r());
+    }
+}
+
+TEST(test_return_handler, iota)
+{
+    {
+        stub::return_handler<uint32_t> r;
+        r.set_return_iota(0U, 100000U).no_repeat();
+
+        for (uint32_t i = 0; i < 100000U; ++i)
+        {
+            ASSERT_EQ(i, r());
+        }
+    }
+
+    {
+        stub::return_handler<int64_t> r;
+        r.set_return_iota(-1, 3U);
+
+        EXPECT_EQ(-1, r());
+        EXPECT_EQ(0, r());
+        EXPECT_EQ(1, r());
+        EXPECT_EQ(-1, r());
+    }
+}
+
+TEST(test_return_handler, file)
+{
+    const std::string path = "test_return_handler_file.bin";
+
+    {
+        const uint32_t values[] = {1U, 2U, 3U};
+        std::ofstream file(path, std::ios::binary);
+        file.write((const char*)values, sizeof(values));
+    }
+
+    {
+        stub::return_handler<uint32_t> r;
+        r.set_return_file(path);
+
+        EXPECT_EQ(1U, r());
+        EXPECT_EQ(2U, r());
+        EXPECT_EQ(3U, r());
+        EXPECT_EQ(1U, r());
+
+        r.set_return_file(path).no_repeat();
+
+        EXPECT_EQ(1U, r());
+        EXPECT_EQ(2U, r());
+        EXPECT_EQ(3U, r());
+    }
+
+    {
+        // The file size is not a multiple of the return type size
+        stub::return_handler<uint64_t> r;
+        r.set_return(4U);
+
+        EXPECT_THROW(r.set_return_file(path), std::runtime_error);
+
+        // The return handler is unchanged
+        EXPECT_EQ(4U, r());
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST(test_return_handler, atomic_cursor)
+{
+    const uint32_t threads = 4;
+    const uint32_t values = 1000;
+
+    stub::return_handler<uint32_t> r;
+    r.set_return_iota(0U, values).no_repeat().atomic_cursor();
+
+    std::vector<std::vector<uint32_t>> returned(threads);
+    std::vector<std::thread> workers;
+
+    for (uint32_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(
+            [&r, &returned, i]()
+            {
+                try
+                {
+                    while (true)
+                    {
+                        returned[i].push_back(r());
+                    }
+                }
+                catch (const stub::return_exhausted&)
+                {
+                }
+            });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    // Every value is returned exactly once
+    std::vector<uint32_t> all;
+    for (const auto& v : returned)
+    {
+        all.insert(all.end(), v.begin(), v.end());
+    }
+
+    std::sort(all.begin(), all.end());
+
+    ASSERT_EQ(values, all.size());
+    for (uint32_t i = 0; i < values; ++i)
+    {
+        EXPECT_EQ(i, all[i]);
+    }
+
+    EXPECT_THROW(r(), stub::return_exhausted);
+
+    // With repeat the values wrap around
+    r.set_return(1U, 2U).atomic_cursor();
+
+    EXPECT_EQ(1U, r());
+    EXPECT_EQ(2U, r());
+    EXPECT_EQ(1U, r());
+}
+
+TEST(test_return_handler, per_thread_cursor)
+{
+    const uint32_t threads = 4;
+
+    stub::return_handler<uint32_t> r;
+    r.set_return(1U, 2U, 3U).no_repeat().per_thread_cursor();
+
+    std::vector<std::vector<uint32_t>> returned(threads);
+    std::vector<uint8_t> exhausted(threads, false);
+    std::vector<std::thread> workers;
+
+    for (uint32_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(
+            [&r, &returned, &exhausted, i]()
+            {
+                for (uint32_t j = 0; j < 3; ++j)
+                {
+                    returned[i].push_back(r());
+                }
+
+                try
+                {
+                    r();
+                }
+                catch (const stub::return_exhausted&)
+                {
+                    exhausted[i] = true;
+                }
+            });
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    // Every thread sees the full sequence
+    for (uint32_t i = 0; i < threads; ++i)
+    {
+        EXPECT_EQ(std::vector<uint32_t>({1U, 2U, 3U}), returned[i]);
+        EXPECT_TRUE(exhausted[i]);
+    }
+}
+
+TEST(test_return_handler, per_thread_cursor_copy)
+{
+    stub::return_handler<uint32_t> r;
+    r.set_return(1U, 2U, 3U).per_thread_cursor();
+
+    EXPECT_EQ(1U, r());
+
+    // The copy has its own positions starting where the original was
+    stub::return_handler<uint32_t> copy = r;
+
+    EXPECT_EQ(2U, copy());
+    EXPECT_EQ(3U, copy());
+    EXPECT_EQ(2U, r());
+}
+
+TEST(test_return_handler, memory_usage)
+{
+    stub::return_handler<uint64_t> handler;
+    EXPECT_EQ(0U, handler.memory_usage());
+
+    handler.set_return(1U, 2U, 3U);
+    EXPECT_LE(3 * sizeof(uint64_t), handler.memory_usage());
+
+    // Lazily generated values are not stored
+    handler.set_return_iota(0U, 1000000U);
+    EXPECT_GT(1000000 * sizeof(uint64_t), handler.memory_usage());
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/return_table.hpp>
+
+#include <stub/ignore.hpp>
+#include <stub/make_compare.hpp>
+#include <stub/not_nullptr.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(test_return_table, void)
+{
+    // Just checking that it can be instantiated
+    stub::return_table<void, uint32_t> table;
+    stub::return_handler<void> fallback;
+
+    table(std::make_tuple(1U), fallback);
+}
+
+TEST(test_return_table, api)
+{
+    stub::return_table<uint32_t, uint64_t, bool> table;
+    table.set_return_for(1U, true, 10U).set_return_for(1U, false, 11U);
+    table.set_return_for(2U, true, 20U);
+
+    EXPECT_EQ(3U, table.size());
+
+    stub::return_handler<uint32_t> fallback;
+    fallback.set_return(0U);
+
+    EXPECT_EQ(10U, table(std::make_tuple(1U, true), fallback));
+    EXPECT_EQ(11U, table(std::make_tuple(1U, false), fallback));
+    EXPECT_EQ(20U, table(std::make_tuple(2U, true), fallback));
+    EXPECT_EQ(0U, table(std::make_tuple(2U, false), fallback));
+
+    // Overwrite a return value
+    table.set_return_for(2U, true, 21U);
+
+    EXPECT_EQ(3U, table.size());
+    EXPECT_EQ(21U, table(std::make_tuple(2U, true), fallback));
+}
+
+TEST(test_return_table, copy)
+{
+    stub::return_table<std::string, std::string> table;
+    table.set_return_for("a", "1");
+
+    stub::return_table<std::string, std::string> copy = table;
+    copy.set_return_for("a", "2");
+
+    stub::return_handler<std::string> fallback;
+    fallback.set_return("");
+
+    EXPECT_EQ("1", table(std::make_tuple(std::string("a")), fallback));
+    EXPECT_EQ("2", copy(std::make_tuple(std::string("a")), fallback));
+}
+
+TEST(test_return_table, many)
+{
+    const uint64_t entries = 100000;
+
+    stub::return_table<uint64_t, uint64_t> table;
+    table.reserve(entries);
+
+    for (uint64_t i = 0; i < entries; ++i)
+    {
+        table.set_return_for(i, i * 2);
+    }
+
+    stub::return_handler<uint64_t> fallback;
+
+    for (uint64_t i = 0; i < entries; ++i)
+    {
+        ASSERT_EQ(i * 2, table(std::make_tuple(i), fallback));
+    }
+}
+
+TEST(test_return_table, rules)
+{
+    stub::return_table<uint32_t, uint64_t, const uint8_t*> table;
+
+    uint8_t data = 0;
+
+    // Exact rules are stored in the hash table and take precedence
+    table.when(stub::ignore(), stub::not_nullptr()).then_return(1U);
+    table.when(stub::make_compare([](uint64_t v) { return v > 10U; }),
+               stub::ignore())
+        .then_return(2U);
+    table.when(5U, &data).then_return(3U);
+
+    EXPECT_EQ(3U, table.size());
+
+    stub::return_handler<uint32_t> fallback;
+    fallback.set_return(0U);
+
+    EXPECT_EQ(1U, table(std::make_tuple(1U, &data), fallback));
+    EXPECT_EQ(3U, table(std::make_tuple(5U, &data), fallback));
+    EXPECT_EQ(2U, table(std::make_tuple(11U, nullptr), fallback));
+    EXPECT_EQ(0U, table(std::make_tuple(1U, nullptr), fallback));
+}
+
+namespace
+{
+struct cup
+{
+    double m_volume;
+};
+
+bool operator==(const cup& a, const cup& b)
+{
+    return a.m_volume == b.m_volume;
+}
+}
+
+TEST(test_return_table, rules_without_hash)
+{
+    // Types without std::hash can be used in rules, they are compared one
+    // by one
+    stub::return_table<bool, cup> table;
+    table.when(cup{2.0}).then_return(true);
+
+    stub::return_handler<bool> fallback;
+    fallback.set_return(false);
+
+    EXPECT_TRUE(table(std::make_tuple(cup{2.0}), fallback));
+    EXPECT_FALSE(table(std::make_tuple(cup{3.0}), fallback));
+}
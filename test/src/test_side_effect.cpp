@@ -0,0 +1,79 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/side_effect.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <gtest/gtest.h>
+
+TEST(test_side_effect, traits)
+{
+    auto none = []() {};
+    auto args = [](const uint32_t&, const std::string&) {};
+    auto indexed = [](uint32_t, const uint32_t&, const std::string&) {};
+
+    EXPECT_TRUE((stub::is_callable_with<decltype(none), std::tuple<>>::value));
+    EXPECT_FALSE((stub::is_arguments_side_effect<decltype(none), uint32_t,
+                                                 std::string>::value));
+
+    EXPECT_TRUE((stub::is_arguments_side_effect<decltype(args), uint32_t,
+                                                const std::string&>::value));
+    EXPECT_FALSE((stub::is_indexed_side_effect<decltype(args), uint32_t,
+                                               std::string>::value));
+
+    EXPECT_TRUE((stub::is_indexed_side_effect<decltype(indexed), uint32_t,
+                                              std::string>::value));
+}
+
+TEST(test_side_effect, adapters)
+{
+    auto call = std::make_tuple(4U, std::string("hello"));
+
+    std::string seen;
+    uint32_t seen_index = 0;
+
+    stub::side_effect<uint32_t, std::string> a =
+        stub::arguments_side_effect<std::function<void(uint32_t,
+                                                       const std::string&)>>{
+            [&seen](uint32_t, const std::string& s) { seen = s; }};
+
+    stub::side_effect<uint32_t, std::string> b =
+        stub::indexed_side_effect<std::function<void(
+            uint32_t, uint32_t, const std::string&)>>{
+            [&seen_index](uint32_t index, uint32_t, const std::string&)
+            { seen_index = index; }};
+
+    a(call, 3U);
+    b(call, 3U);
+
+    EXPECT_EQ("hello", seen);
+    EXPECT_EQ(3U, seen_index);
+}
+
+TEST(test_side_effect, make_side_effect)
+{
+    auto call = std::make_tuple(4U);
+
+    uint32_t none = 0;
+    uint32_t value = 0;
+    uint32_t index = 0;
+
+    auto a = stub::make_side_effect<uint32_t>([&none]() { ++none; });
+    auto b = stub::make_side_effect<uint32_t>([&value](const uint32_t& v)
+                                              { value = v; });
+    auto c = stub::make_side_effect<uint32_t>(
+        [&index](uint32_t i, const uint32_t&) { index = i; });
+
+    a(call, 2U);
+    b(call, 2U);
+    c(call, 2U);
+
+    EXPECT_EQ(1U, none);
+    EXPECT_EQ(4U, value);
+    EXPECT_EQ(2U, index);
+}
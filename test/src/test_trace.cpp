@@ -0,0 +1,122 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/trace.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(test_trace, write_read)
+{
+    stub::function<void(uint32_t, const std::string&, int8_t*)> function;
+
+    function(4U, "hello", (int8_t*)0x10);
+    function(5U, "world", nullptr);
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    auto calls =
+        stub::read_trace<uint32_t, const std::string&, int8_t*>(stream);
+
+    ASSERT_EQ(2U, calls.size());
+    EXPECT_EQ(function.call_arguments(0), calls[0]);
+    EXPECT_EQ(function.call_arguments(1), calls[1]);
+}
+
+TEST(test_trace, compact)
+{
+    stub::function<void(uint32_t)> function;
+
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        function(i % 100);
+    }
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    // Small values are stored in a single byte after the header
+    EXPECT_GT(1100U, stream.str().size());
+}
+
+TEST(test_trace, no_arguments)
+{
+    stub::function<void()> function;
+
+    function();
+    function();
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    EXPECT_EQ(2U, stub::read_trace<>(stream).size());
+}
+
+TEST(test_trace, wrong_types)
+{
+    stub::function<void(uint32_t)> function;
+    function(4U);
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    EXPECT_THROW(stub::read_trace<int32_t>(stream), stub::trace_error);
+
+    std::stringstream invalid("not a trace");
+    EXPECT_THROW(stub::read_trace<uint32_t>(invalid), stub::trace_error);
+}
+
+TEST(test_trace, truncated)
+{
+    stub::function<void(std::string)> function;
+    function("hello");
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    std::string data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+
+    EXPECT_THROW(stub::read_trace<std::string>(truncated), stub::trace_error);
+}
+
+TEST(test_trace, reader)
+{
+    stub::function<void(int32_t, std::vector<uint8_t>, bool,
+                        std::vector<std::pair<char, double>>)>
+        function;
+
+    function(-4, {0x01, 0xab}, true, {{'a', 1.5}, {'b', -2.0}});
+    function(7, {}, false, {});
+
+    std::stringstream stream;
+    stub::write_trace(stream, function);
+
+    stub::trace_reader reader(stream);
+
+    std::vector<std::string> types = {"i32", "bytes", "bool",
+                                      "vec<(char,f64)>"};
+    EXPECT_EQ(types, reader.types());
+    EXPECT_EQ(2U, reader.calls());
+
+    std::vector<std::string> values;
+
+    EXPECT_TRUE(reader.read_call(values));
+    std::vector<std::string> first = {"-4", "01ab", "1",
+                                      "[(a, 1.5), (b, -2)]"};
+    EXPECT_EQ(first, values);
+
+    EXPECT_TRUE(reader.read_call(values));
+    std::vector<std::string> second = {"7", "", "0", "[]"};
+    EXPECT_EQ(second, values);
+
+    EXPECT_FALSE(reader.read_call(values));
+    EXPECT_EQ(2U, reader.position());
+}
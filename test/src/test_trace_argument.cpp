@@ -0,0 +1,97 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/trace_argument.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+template <class T>
+T round_trip(const T& value)
+{
+    std::stringstream stream;
+    stub::trace_output out(*stream.rdbuf());
+    stub::trace_argument<T>::write(out, value);
+
+    stub::trace_input in(*stream.rdbuf());
+    T result = stub::trace_argument<T>::read(in);
+
+    EXPECT_TRUE(in.at_end());
+    return result;
+}
+
+enum class color : uint8_t
+{
+    red,
+    green
+};
+}
+
+TEST(test_trace_argument, types)
+{
+    EXPECT_EQ("bool", stub::trace_argument<bool>::type());
+    EXPECT_EQ("char", stub::trace_argument<char>::type());
+    EXPECT_EQ("u8", stub::trace_argument<uint8_t>::type());
+    EXPECT_EQ("i16", stub::trace_argument<int16_t>::type());
+    EXPECT_EQ("u32", stub::trace_argument<uint32_t>::type());
+    EXPECT_EQ("i64", stub::trace_argument<int64_t>::type());
+    EXPECT_EQ("f32", stub::trace_argument<float>::type());
+    EXPECT_EQ("f64", stub::trace_argument<double>::type());
+    EXPECT_EQ("u8", stub::trace_argument<color>::type());
+    EXPECT_EQ("ptr", stub::trace_argument<uint8_t*>::type());
+    EXPECT_EQ("str", stub::trace_argument<std::string>::type());
+    EXPECT_EQ("bytes", stub::trace_argument<std::vector<uint8_t>>::type());
+    EXPECT_EQ("vec<i32>", stub::trace_argument<std::vector<int32_t>>::type());
+    EXPECT_EQ("(u32,str)",
+              (stub::trace_argument<std::pair<uint32_t, std::string>>::type()));
+    EXPECT_EQ("(bool,vec<f64>)",
+              (stub::trace_argument<
+                  std::tuple<bool, std::vector<double>>>::type()));
+}
+
+TEST(test_trace_argument, round_trip)
+{
+    EXPECT_EQ(true, round_trip(true));
+    EXPECT_EQ('x', round_trip('x'));
+    EXPECT_EQ(200U, round_trip((uint8_t)200));
+    EXPECT_EQ(-3, round_trip((int16_t)-3));
+    EXPECT_EQ(123456789U, round_trip(123456789U));
+    EXPECT_EQ(-1234567890123LL, round_trip((int64_t)-1234567890123LL));
+    EXPECT_EQ(3.5f, round_trip(3.5f));
+    EXPECT_EQ(-0.125, round_trip(-0.125));
+    EXPECT_EQ(color::green, round_trip(color::green));
+    EXPECT_EQ((uint8_t*)0xdeadbeef, round_trip((uint8_t*)0xdeadbeef));
+    EXPECT_EQ("hello", round_trip(std::string("hello")));
+
+    std::vector<uint8_t> bytes = {0, 1, 255};
+    EXPECT_EQ(bytes, round_trip(bytes));
+
+    std::vector<int32_t> values = {-1, 0, 100000};
+    EXPECT_EQ(values, round_trip(values));
+
+    auto tuple = std::make_tuple(std::string("a"), 2U, false);
+    EXPECT_EQ(tuple, round_trip(tuple));
+
+    auto pair = std::make_pair(7, std::string("b"));
+    EXPECT_EQ(pair, round_trip(pair));
+}
+
+TEST(test_trace_argument, out_of_range)
+{
+    std::stringstream stream;
+    stub::trace_output out(*stream.rdbuf());
+    stub::trace_argument<uint32_t>::write(out, 300U);
+
+    stub::trace_input in(*stream.rdbuf());
+    EXPECT_THROW(stub::trace_argument<uint8_t>::read(in), stub::trace_error);
+}
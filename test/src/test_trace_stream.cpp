@@ -0,0 +1,77 @@
+// Copyright (c) 2026 Steinwurf ApS
+// All Rights Reserved
+//
+// Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+#include <stub/trace_stream.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+TEST(test_trace_stream, varint)
+{
+    std::stringstream stream;
+    stub::trace_output out(*stream.rdbuf());
+
+    out.write_varint(0);
+    out.write_varint(127);
+    out.write_varint(128);
+    out.write_varint(std::numeric_limits<uint64_t>::max());
+
+    // One byte per 7 bits
+    EXPECT_EQ(1U + 1U + 2U + 10U, stream.str().size());
+
+    stub::trace_input in(*stream.rdbuf());
+    EXPECT_EQ(0U, in.read_varint());
+    EXPECT_EQ(127U, in.read_varint());
+    EXPECT_EQ(128U, in.read_varint());
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), in.read_varint());
+    EXPECT_TRUE(in.at_end());
+}
+
+TEST(test_trace_stream, zigzag)
+{
+    std::stringstream stream;
+    stub::trace_output out(*stream.rdbuf());
+
+    out.write_zigzag(0);
+    out.write_zigzag(-1);
+    out.write_zigzag(63);
+    out.write_zigzag(-64);
+    out.write_zigzag(std::numeric_limits<int64_t>::min());
+    out.write_zigzag(std::numeric_limits<int64_t>::max());
+
+    // Small negative values are also a single byte
+    EXPECT_EQ(4U + 10U + 10U, stream.str().size());
+
+    stub::trace_input in(*stream.rdbuf());
+    EXPECT_EQ(0, in.read_zigzag());
+    EXPECT_EQ(-1, in.read_zigzag());
+    EXPECT_EQ(63, in.read_zigzag());
+    EXPECT_EQ(-64, in.read_zigzag());
+    EXPECT_EQ(std::numeric_limits<int64_t>::min(), in.read_zigzag());
+    EXPECT_EQ(std::numeric_limits<int64_t>::max(), in.read_zigzag());
+}
+
+TEST(test_trace_stream, fixed)
+{
+    std::stringstream stream;
+    stub::trace_output out(*stream.rdbuf());
+
+    out.write_fixed(0x01020304, 4);
+    EXPECT_EQ(std::string("\x04\x03\x02\x01"), stream.str());
+
+    stub::trace_input in(*stream.rdbuf());
+    EXPECT_EQ(0x01020304U, in.read_fixed(4));
+}
+
+TEST(test_trace_stream, truncated)
+{
+    std::stringstream stream(std::string("\x80"));
+    stub::trace_input in(*stream.rdbuf());
+
+    EXPECT_THROW(in.read_varint(), stub::trace_error);
+}
@@ -0,0 +1,128 @@
+#! /usr/bin/env python
+# encoding: utf-8
+#
+# Copyright (c) 2026 Steinwurf ApS
+# All Rights Reserved
+#
+# Distributed under the "BSD License". See the accompanying LICENSE.rst file.
+
+"""Generate a single header containing all stub headers.
+
+The headers in src/stub are inlined in dependency order, such that every
+header appears once and after the headers it includes. Includes of
+standard and system headers are kept in place.
+
+Usage:
+
+    python amalgamate.py --src src/stub --output build/amalgamated/stub.hpp
+"""
+
+import argparse
+import os
+import re
+
+LOCAL_INCLUDE = re.compile(r'^\s*#\s*include\s+"([^"]+)"\s*$')
+PRAGMA_ONCE = re.compile(r"^\s*#\s*pragma\s+once\s*$")
+COPYRIGHT = re.compile(r"^//")
+
+# Headers which are opt-in, i.e. only used together with a compiled library
+# or pulling in the system headers of the platform, their includes are kept
+# as they are
+EXCLUDED = {
+    "async_dispatcher.hpp",
+    "async_side_effects.hpp",
+    "extern_templates.hpp",
+    "mapped_file.hpp",
+    "return_file.hpp",
+}
+
+
+def strip_header(lines):
+    """Remove the copyright comment at the top of a header"""
+
+    index = 0
+    while index < len(lines) and COPYRIGHT.match(lines[index]):
+        index += 1
+    return lines[index:]
+
+
+def inline(src, name, visited, output):
+    """Append the header and the headers it includes to the output"""
+
+    if name in visited:
+        return
+    visited.add(name)
+
+    with open(os.path.join(src, name)) as f:
+        lines = strip_header(f.read().splitlines())
+
+    body = ["", "// ---- stub/{} ----".format(name)]
+
+    for line in lines:
+        if PRAGMA_ONCE.match(line):
+            continue
+
+        match = LOCAL_INCLUDE.match(line)
+        if match and match.group(1) not in EXCLUDED:
+            # Inline the included header before this one
+            inline(src, match.group(1), visited, output)
+            continue
+
+        body.append(line)
+
+    output.extend(body)
+
+
+def amalgamate(src):
+    """@return The single header as a string"""
+
+    headers = sorted(
+        name
+        for name in os.listdir(src)
+        if name.endswith(".hpp") and name not in EXCLUDED
+    )
+
+    output = [
+        "// Copyright (c) 2026 Steinwurf ApS",
+        "// All Rights Reserved",
+        "//",
+        '// Distributed under the "BSD License". See the accompanying '
+        "LICENSE.rst file.",
+        "//",
+        "// Single header version of the stub headers in src/stub generated by",
+        "// tools/amalgamate.py. Do not edit.",
+        "",
+        "#pragma once",
+    ]
+
+    visited = set()
+    for name in headers:
+        inline(src, name, visited, output)
+
+    return "\n".join(output) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--src", required=True, help="The src/stub directory")
+    parser.add_argument("--output", required=True, help="The header to write")
+    args = parser.parse_args()
+
+    content = amalgamate(args.src)
+
+    directory = os.path.dirname(args.output)
+    if directory and not os.path.isdir(directory):
+        os.makedirs(directory)
+
+    # Only write when changed to avoid rebuilding the dependent targets
+    if os.path.isfile(args.output):
+        with open(args.output) as f:
+            if f.read() == content:
+                return
+
+    with open(args.output, "w") as f:
+        f.write(content)
+
+
+if __name__ == "__main__":
+    main()